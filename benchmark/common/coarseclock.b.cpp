@@ -0,0 +1,50 @@
+#include <benchmark/benchmark.h>
+
+#include <resilient/common/coarseclock.hpp>
+#include <resilient/policy/circuitbreakerstrategy/countstrategy.hpp>
+#include <resilient/policy/circuitbreakerstrategy/lockfreecountstrategy.hpp>
+
+#include <chrono>
+
+using namespace resilient;
+using namespace std::chrono_literals;
+
+namespace {
+
+template<typename Clock>
+void BM_Now(benchmark::State& state)
+{
+    Clock clock;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(clock.now());
+    }
+}
+
+// Every call fails, so the strategy reads the clock on each of them.
+template<typename Strategy>
+void BM_FailedCalls(benchmark::State& state)
+{
+    // Never trip, we want to measure the closed state.
+    static Strategy strategy{1000000000ul, 1s, 1s, 1};
+    for (auto _ : state) {
+        if (strategy.allowCall()) {
+            strategy.registerFailure();
+        }
+    }
+}
+
+} // namespace
+
+BENCHMARK_TEMPLATE(BM_Now, std::chrono::steady_clock);
+BENCHMARK_TEMPLATE(BM_Now, CoarseClock);
+BENCHMARK_TEMPLATE(BM_Now, MonotonicCoarseClock);
+
+BENCHMARK_TEMPLATE(BM_FailedCalls, CountStrategy<std::chrono::steady_clock>);
+BENCHMARK_TEMPLATE(BM_FailedCalls, CountStrategy<CoarseClock>);
+BENCHMARK_TEMPLATE(BM_FailedCalls, CountStrategy<MonotonicCoarseClock>);
+BENCHMARK_TEMPLATE(BM_FailedCalls, LockFreeCountStrategy<std::chrono::steady_clock>)
+    ->ThreadRange(1, 8)
+    ->UseRealTime();
+BENCHMARK_TEMPLATE(BM_FailedCalls, LockFreeCountStrategy<CoarseClock>)
+    ->ThreadRange(1, 8)
+    ->UseRealTime();
@@ -0,0 +1,24 @@
+#include <benchmark/benchmark.h>
+
+#include <resilient/common/timerwheel.hpp>
+
+#include <chrono>
+
+using namespace resilient;
+using namespace std::chrono_literals;
+
+namespace {
+
+// Most timers of retries and timeouts are cancelled before they expire.
+void BM_ScheduleAndCancel(benchmark::State& state)
+{
+    static TimerWheel wheel{1ms};
+    for (auto _ : state) {
+        TimerHandle handle = wheel.schedule(100ms, []() {});
+        benchmark::DoNotOptimize(wheel.cancel(handle));
+    }
+}
+
+} // namespace
+
+BENCHMARK(BM_ScheduleAndCancel)->ThreadRange(1, 8)->UseRealTime();
@@ -0,0 +1,43 @@
+#include <benchmark/benchmark.h>
+
+#include <resilient/policy/circuitbreaker.hpp>
+#include <resilient/policy/circuitbreakerstrategy/countstrategy.hpp>
+#include <resilient/policy/circuitbreakerstrategy/lockfreecountstrategy.hpp>
+#include <resilient/task/failable.hpp>
+
+#include <chrono>
+#include <memory>
+
+using namespace resilient;
+using namespace std::chrono_literals;
+
+namespace {
+
+struct Failure
+{
+};
+
+using Result = Failable<int, Failure>;
+
+// The overhead the circuit breaker adds to a call which does nothing.
+template<typename Circuitbreaker, typename Strategy>
+void BM_Execute(benchmark::State& state)
+{
+    // Never trip, we want to measure the closed state.
+    Circuitbreaker circuitbreaker{
+        std::unique_ptr<Strategy>(new Strategy(1000000000ul, 1s, 1s, 1))};
+    int value = 0;
+    for (auto _ : state) {
+        auto result = circuitbreaker.execute([&value]() { return Result(value++); });
+        benchmark::DoNotOptimize(result);
+    }
+}
+
+} // namespace
+
+BENCHMARK_TEMPLATE(BM_Execute, Circuitbreaker, CountStrategy<>);
+BENCHMARK_TEMPLATE(BM_Execute, BasicCircuitbreaker<CountStrategy<>>, CountStrategy<>);
+BENCHMARK_TEMPLATE(BM_Execute, Circuitbreaker, LockFreeCountStrategy<>);
+BENCHMARK_TEMPLATE(BM_Execute,
+                   BasicCircuitbreaker<LockFreeCountStrategy<>>,
+                   LockFreeCountStrategy<>);
@@ -0,0 +1,66 @@
+#include <benchmark/benchmark.h>
+
+#include <resilient/policy/circuitbreakerstrategy/countstrategy.hpp>
+#include <resilient/policy/circuitbreakerstrategy/lockfreecountstrategy.hpp>
+
+#include <chrono>
+
+using namespace resilient;
+using namespace std::chrono_literals;
+
+namespace {
+
+// All the threads of a benchmark share the same strategy, as they would when calling the same
+// dependency.
+template<typename Strategy>
+Strategy& sharedStrategy()
+{
+    // Never trip, we want to measure the closed state.
+    static Strategy strategy{1000000000ul, 1s, 1s, 1};
+    return strategy;
+}
+
+template<typename Strategy>
+void BM_SuccessfulCalls(benchmark::State& state)
+{
+    Strategy& strategy = sharedStrategy<Strategy>();
+    for (auto _ : state) {
+        if (strategy.allowCall()) {
+            strategy.registerSuccess();
+        }
+    }
+}
+
+// One call every 100 fails.
+template<typename Strategy>
+void BM_MostlySuccessfulCalls(benchmark::State& state)
+{
+    Strategy& strategy = sharedStrategy<Strategy>();
+    unsigned int call = 0;
+    for (auto _ : state) {
+        if (strategy.allowCall()) {
+            if (++call % 100 == 0) {
+                strategy.registerFailure();
+            }
+            else
+            {
+                strategy.registerSuccess();
+            }
+        }
+    }
+}
+
+using ShardedLockFreeCountStrategy =
+    LockFreeCountStrategy<std::chrono::steady_clock, ShardedFailureCounter<>>;
+
+} // namespace
+
+BENCHMARK_TEMPLATE(BM_SuccessfulCalls, CountStrategy<>)->ThreadRange(1, 32)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_SuccessfulCalls, LockFreeCountStrategy<>)->ThreadRange(1, 32)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_MostlySuccessfulCalls, CountStrategy<>)->ThreadRange(1, 32)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_MostlySuccessfulCalls, LockFreeCountStrategy<>)
+    ->ThreadRange(1, 32)
+    ->UseRealTime();
+BENCHMARK_TEMPLATE(BM_MostlySuccessfulCalls, ShardedLockFreeCountStrategy)
+    ->ThreadRange(1, 32)
+    ->UseRealTime();
@@ -0,0 +1,64 @@
+#include <benchmark/benchmark.h>
+
+#include <resilient/policy/ratelimiter.hpp>
+#include <resilient/policy/ratelimiterstrategy/tokenbucketstrategy.hpp>
+#include <resilient/task/failable.hpp>
+
+#include <chrono>
+#include <memory>
+#include <numeric>
+#include <vector>
+
+using namespace resilient;
+using namespace std::chrono_literals;
+
+namespace {
+
+struct Failure
+{
+};
+
+using Result = Failable<int, Failure>;
+
+// A rate which never limits: we want to measure the cost of acquiring the permits.
+std::unique_ptr<TokenBucketStrategy<>> unlimited()
+{
+    return std::unique_ptr<TokenBucketStrategy<>>(
+        new TokenBucketStrategy<>(1000000000ul, 1us, 1000000000ul, 0us));
+}
+
+// Fan out `state.range(0)` tasks, acquiring a permit for each one.
+void BM_ExecuteEach(benchmark::State& state)
+{
+    Ratelimiter<TokenBucketStrategy<>> ratelimiter{unlimited()};
+    std::vector<int> values(static_cast<std::size_t>(state.range(0)));
+    std::iota(values.begin(), values.end(), 0);
+    for (auto _ : state) {
+        for (int value : values) {
+            auto result = ratelimiter.execute([value]() { return Result(value); });
+            benchmark::DoNotOptimize(result);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// Fan out `state.range(0)` tasks, acquiring a single permit for all of them.
+void BM_ExecuteBatch(benchmark::State& state)
+{
+    Ratelimiter<TokenBucketStrategy<>> ratelimiter{unlimited()};
+    std::vector<int> values(static_cast<std::size_t>(state.range(0)));
+    std::iota(values.begin(), values.end(), 0);
+    for (auto _ : state) {
+        auto results =
+            ratelimiter.executeBatch(values.begin(), values.end(), [](int value) {
+                return Result(value);
+            });
+        benchmark::DoNotOptimize(results);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+} // namespace
+
+BENCHMARK(BM_ExecuteEach)->RangeMultiplier(10)->Range(1, 1000);
+BENCHMARK(BM_ExecuteBatch)->RangeMultiplier(10)->Range(1, 1000);
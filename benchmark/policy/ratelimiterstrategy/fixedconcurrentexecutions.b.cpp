@@ -0,0 +1,46 @@
+#include <benchmark/benchmark.h>
+
+#include <resilient/policy/ratelimiterstrategy/blockingfixedconcurrentexecutionsstrategy.hpp>
+#include <resilient/policy/ratelimiterstrategy/spinningfixedconcurrentexecutionsstrategy.hpp>
+
+#include <chrono>
+
+using namespace resilient;
+using namespace std::chrono_literals;
+
+namespace {
+
+// Busy wait instead of sleeping: sleeping for a few microseconds takes much longer.
+void hold(std::chrono::nanoseconds duration)
+{
+    const auto end = std::chrono::steady_clock::now() + duration;
+    while (std::chrono::steady_clock::now() < end) {
+    }
+}
+
+// The threads compete for 2 permits, holding each one for `state.range(0)` nanoseconds.
+template<typename Strategy>
+void BM_AcquireRelease(benchmark::State& state)
+{
+    // Shared by the threads. All the permits are released at the end of each run.
+    static Strategy strategy{2, 1s};
+    const std::chrono::nanoseconds holdTime(state.range(0));
+    for (auto _ : state) {
+        auto permit = strategy.acquire();
+        hold(holdTime);
+        strategy.release(std::move(get<MaxConcurrentPermit>(permit)));
+    }
+}
+
+} // namespace
+
+BENCHMARK_TEMPLATE(BM_AcquireRelease, BlockingFixedConcurrentExecutionsStrategy)
+    ->RangeMultiplier(4)
+    ->Range(0, 64 << 10)
+    ->Threads(4)
+    ->UseRealTime();
+BENCHMARK_TEMPLATE(BM_AcquireRelease, SpinningFixedConcurrentExecutionsStrategy)
+    ->RangeMultiplier(4)
+    ->Range(0, 64 << 10)
+    ->Threads(4)
+    ->UseRealTime();
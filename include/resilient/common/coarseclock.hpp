@@ -0,0 +1,157 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+#if defined(__linux__)
+#include <time.h>
+#endif
+
+namespace resilient {
+
+/**
+ * @brief Keep a cached reading of `std::chrono::steady_clock`, refreshed by a background thread.
+ * @related resilient::CoarseClock
+ *
+ * Reading the cached time is a single relaxed atomic load, which is much cheaper than reading
+ * the clock. The reading is late by at most `resolution` (plus the scheduling delay of the
+ * thread).
+ *
+ * The ticker must outlive the clocks which use it.
+ */
+class CoarseClockTicker
+{
+public:
+    /**
+     * @brief Start a thread updating the time every `resolution`.
+     */
+    explicit CoarseClockTicker(std::chrono::microseconds resolution)
+    : d_now(read()), d_resolution(resolution), d_stopping(false), d_thread([this]() { run(); })
+    {
+    }
+
+    CoarseClockTicker(const CoarseClockTicker&) = delete;
+    CoarseClockTicker& operator=(const CoarseClockTicker&) = delete;
+
+    ~CoarseClockTicker()
+    {
+        {
+            std::lock_guard<std::mutex> guard{d_mutex};
+            d_stopping = true;
+        }
+        d_wakeUp.notify_one();
+        d_thread.join();
+    }
+
+    /**
+     * @brief The time since the epoch of `std::chrono::steady_clock` at the last tick.
+     */
+    std::chrono::steady_clock::duration sinceEpoch() const
+    {
+        return std::chrono::steady_clock::duration(d_now.load(std::memory_order_relaxed));
+    }
+
+    /**
+     * @brief How often the time is updated.
+     */
+    std::chrono::microseconds resolution() const { return d_resolution; }
+
+private:
+    using rep = std::chrono::steady_clock::rep;
+
+    static rep read() { return std::chrono::steady_clock::now().time_since_epoch().count(); }
+
+    void run()
+    {
+        std::unique_lock<std::mutex> lock{d_mutex};
+        while (not d_wakeUp.wait_for(lock, d_resolution, [this]() { return d_stopping; })) {
+            d_now.store(read(), std::memory_order_relaxed);
+        }
+    }
+
+    // Read by every thread using the clock: keep it away from the data the ticker writes.
+    alignas(64) std::atomic<rep> d_now;
+    std::chrono::microseconds d_resolution;
+    alignas(64) std::mutex d_mutex;
+    std::condition_variable d_wakeUp;
+    bool d_stopping;
+    std::thread d_thread;
+};
+
+/**
+ * @brief A clock which trades precision for speed, reading the time cached by a
+ *        `CoarseClockTicker`.
+ *
+ * It can be used as the `Clock` of the strategies, which read the time on many calls, when the
+ * durations they measure are much longer than the resolution of the ticker.
+ *
+ * A default constructed clock uses a ticker shared by the whole process, with a resolution of
+ * 1 millisecond, started the first time it is used.
+ */
+class CoarseClock
+{
+public:
+    using duration = std::chrono::steady_clock::duration;
+    using rep = duration::rep;
+    using period = duration::period;
+    using time_point = std::chrono::time_point<CoarseClock, duration>;
+    static constexpr bool is_steady = true;
+
+    /**
+     * @brief Construct a clock using the ticker shared by the process.
+     */
+    CoarseClock() : d_ticker(&defaultTicker()) {}
+
+    /**
+     * @brief Construct a clock using the given ticker, which must outlive the clock.
+     */
+    explicit CoarseClock(const CoarseClockTicker& ticker) : d_ticker(&ticker) {}
+
+    time_point now() const { return time_point(d_ticker->sinceEpoch()); }
+
+    /**
+     * @brief The ticker used by default constructed clocks.
+     */
+    static const CoarseClockTicker& defaultTicker()
+    {
+        static CoarseClockTicker ticker{std::chrono::milliseconds(1)};
+        return ticker;
+    }
+
+private:
+    const CoarseClockTicker* d_ticker;
+};
+
+/**
+ * @brief A clock which reads `CLOCK_MONOTONIC_COARSE`.
+ *
+ * On Linux reading the coarse monotonic clock doesn't read the hardware clock, at the cost of
+ * a resolution of a few milliseconds (the kernel tick), and doesn't need a background thread.
+ * On other systems it's the same as `std::chrono::steady_clock`.
+ */
+struct MonotonicCoarseClock
+{
+    using duration = std::chrono::nanoseconds;
+    using rep = duration::rep;
+    using period = duration::period;
+    using time_point = std::chrono::time_point<MonotonicCoarseClock, duration>;
+    static constexpr bool is_steady = true;
+
+    static time_point now() noexcept
+    {
+#if defined(__linux__) && defined(CLOCK_MONOTONIC_COARSE)
+        timespec now;
+        clock_gettime(CLOCK_MONOTONIC_COARSE, &now);
+        return time_point(std::chrono::seconds(now.tv_sec)
+                          + std::chrono::nanoseconds(now.tv_nsec));
+#else
+        return time_point(std::chrono::duration_cast<duration>(
+            std::chrono::steady_clock::now().time_since_epoch()));
+#endif
+    }
+};
+
+} // namespace resilient
@@ -0,0 +1,206 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <resilient/detail/timerwheel.hpp>
+
+namespace resilient {
+
+/**
+ * @brief Identify a timer of a `TimerWheel`, to cancel it.
+ * @related resilient::TimerWheel
+ */
+class TimerHandle
+{
+public:
+    /**
+     * @brief Construct a handle which doesn't identify any timer.
+     */
+    TimerHandle() : d_node(nullptr), d_generation(0) {}
+
+private:
+    friend class TimerWheel;
+
+    TimerHandle(detail::TimerNode* node, std::uint64_t generation)
+    : d_node(node), d_generation(generation)
+    {
+    }
+
+    detail::TimerNode* d_node;
+    std::uint64_t d_generation;
+};
+
+/**
+ * @brief Run functions after a delay, on a thread owned by the wheel.
+ *
+ * The timers are kept in a hashed hierarchical timer wheel: scheduling and cancelling a timer
+ * take constant time, whatever the number of timers, and the memory of the expired timers is
+ * reused, so short lived timers are cheap. Time is counted in ticks of `tick`: a function runs
+ * at least `delay` after it was scheduled, and usually less than a tick later.
+ *
+ * The driver thread sleeps until the next tick with timers to run, or with timers to move to a
+ * lower level of the wheel, which is at most every `256 * tick`. Without timers it sleeps until
+ * one is scheduled.
+ * The functions run on the driver thread, one after the other and without holding the lock
+ * of the wheel: they can schedule and cancel timers, but they should be short and must not
+ * throw.
+ *
+ * It implements the `Scheduler` concept, so it can be passed to `Retry::executeAsync()`.
+ *
+ * The timers which didn't expire when the wheel is destroyed never run.
+ */
+class TimerWheel
+{
+public:
+    /**
+     * @brief Start the driver thread.
+     *
+     * @param tick The resolution of the timers.
+     */
+    explicit TimerWheel(std::chrono::microseconds tick = std::chrono::milliseconds(1))
+    : d_tick(std::chrono::duration_cast<std::chrono::steady_clock::duration>(tick))
+    , d_start(std::chrono::steady_clock::now())
+    , d_sleepingUntil(0)
+    , d_stopping(false)
+    , d_thread([this]() { run(); })
+    {
+    }
+
+    TimerWheel(const TimerWheel&) = delete;
+    TimerWheel& operator=(const TimerWheel&) = delete;
+
+    ~TimerWheel()
+    {
+        {
+            std::lock_guard<std::mutex> guard{d_mutex};
+            d_stopping = true;
+        }
+        d_wakeUp.notify_one();
+        d_thread.join();
+    }
+
+    /**
+     * @brief Run `function` on the driver thread after `delay`.
+     *
+     * @return A handle to cancel the timer.
+     */
+    TimerHandle schedule(std::chrono::microseconds delay, std::function<void()> function)
+    {
+        using duration = std::chrono::steady_clock::duration;
+        const duration sinceStart = std::chrono::steady_clock::now() - d_start;
+        // Round up, so that it doesn't expire before the delay
+        const std::uint64_t expiry = static_cast<std::uint64_t>(
+            (sinceStart + std::chrono::duration_cast<duration>(delay) + d_tick - duration(1))
+            / d_tick);
+
+        std::unique_lock<std::mutex> lock{d_mutex};
+        if (d_wheel.empty()) {
+            // The wheel doesn't advance while it's empty: catch up, without visiting the slots
+            std::vector<std::function<void()>> none;
+            d_wheel.advance(static_cast<std::uint64_t>(sinceStart / d_tick), none);
+        }
+        detail::TimerNode& node = d_wheel.insert(expiry, std::move(function));
+        TimerHandle handle{&node, node.d_generation};
+        // Wake the driver thread if it sleeps past the new timer
+        const bool wakeUp = node.d_expiry < d_sleepingUntil;
+        if (wakeUp) {
+            d_sleepingUntil = node.d_expiry;
+        }
+        lock.unlock();
+        if (wakeUp) {
+            d_wakeUp.notify_one();
+        }
+        return handle;
+    }
+
+    /**
+     * @brief Cancel the timer of the handle.
+     *
+     * @return Whether the timer was cancelled. False if its function already ran or is
+     *         running, or if it was already cancelled.
+     */
+    bool cancel(TimerHandle handle)
+    {
+        if (handle.d_node == nullptr) {
+            return false;
+        }
+        std::lock_guard<std::mutex> guard{d_mutex};
+        return d_wheel.cancel(*handle.d_node, handle.d_generation);
+    }
+
+    /**
+     * @brief The number of timers which didn't expire and were not cancelled.
+     */
+    std::size_t size() const
+    {
+        std::lock_guard<std::mutex> guard{d_mutex};
+        return d_wheel.size();
+    }
+
+    /**
+     * @brief The resolution of the timers.
+     */
+    std::chrono::microseconds tick() const
+    {
+        return std::chrono::duration_cast<std::chrono::microseconds>(d_tick);
+    }
+
+private:
+    static constexpr std::uint64_t NoTimers = std::numeric_limits<std::uint64_t>::max();
+
+    std::uint64_t currentTick() const
+    {
+        return static_cast<std::uint64_t>((std::chrono::steady_clock::now() - d_start) / d_tick);
+    }
+
+    void run()
+    {
+        std::vector<std::function<void()>> expired;
+        std::unique_lock<std::mutex> lock{d_mutex};
+        while (not d_stopping) {
+            if (d_wheel.empty()) {
+                // Sleep until a timer is scheduled
+                d_sleepingUntil = NoTimers;
+                d_wakeUp.wait(lock, [this]() { return d_stopping or d_sleepingUntil != NoTimers; });
+                continue;
+            }
+            d_sleepingUntil = d_wheel.nextEvent();
+            d_wakeUp.wait_until(
+                lock,
+                d_start + d_tick * static_cast<std::chrono::steady_clock::rep>(d_sleepingUntil));
+            if (d_stopping) {
+                break;
+            }
+            d_wheel.advance(currentTick(), expired);
+            if (not expired.empty()) {
+                lock.unlock();
+                for (auto& function : expired) {
+                    function();
+                }
+                expired.clear();
+                lock.lock();
+            }
+        }
+    }
+
+    std::chrono::steady_clock::duration d_tick;
+    std::chrono::steady_clock::time_point d_start;
+    mutable std::mutex d_mutex;
+    std::condition_variable d_wakeUp;
+    detail::HierarchicalTimerWheel d_wheel;
+    // The tick the driver thread sleeps until: it must be notified of timers expiring earlier
+    std::uint64_t d_sleepingUntil;
+    bool d_stopping;
+    std::thread d_thread;
+};
+
+} // namespace resilient
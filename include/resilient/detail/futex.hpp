@@ -0,0 +1,102 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+
+#if defined(__linux__)
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+#else
+#include <condition_variable>
+#include <mutex>
+#endif
+
+namespace resilient {
+namespace detail {
+
+/**
+ * Hint the processor that the thread is spinning, to save power and to let the other hardware
+ * thread of the core run.
+ */
+inline void cpuRelax()
+{
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+    asm volatile("yield");
+#endif
+}
+
+/**
+ * An atomic integer threads can wait on until it changes, without polling.
+ *
+ * On Linux it's a futex: waking up when no thread is waiting is cheap, and waiting doesn't
+ * take any lock. Elsewhere it falls back to a mutex and a condition variable.
+ *
+ * Like a condition variable, `wait()` can return spuriously: the value must be checked again.
+ */
+class FutexWord
+{
+public:
+    explicit FutexWord(int value) : d_value(value) {}
+
+    FutexWord(const FutexWord&) = delete;
+    FutexWord& operator=(const FutexWord&) = delete;
+
+    std::atomic<int>& value() { return d_value; }
+
+    /**
+     * Wait until woken up, if the value is still `expected`, for at most `timeout`.
+     */
+    void wait(int expected, std::chrono::nanoseconds timeout)
+    {
+        if (timeout <= std::chrono::nanoseconds::zero()) {
+            return;
+        }
+#if defined(__linux__)
+        const auto seconds = std::chrono::duration_cast<std::chrono::seconds>(timeout);
+        timespec relative;
+        relative.tv_sec = static_cast<time_t>(seconds.count());
+        relative.tv_nsec = static_cast<long>((timeout - seconds).count());
+        syscall(SYS_futex, address(), FUTEX_WAIT_PRIVATE, expected, &relative, nullptr, 0);
+#else
+        std::unique_lock<std::mutex> lock{d_mutex};
+        if (d_value.load() == expected) {
+            d_condition.wait_for(lock, timeout);
+        }
+#endif
+    }
+
+    /**
+     * Wake up one of the waiting threads, if any.
+     */
+    void wakeOne()
+    {
+#if defined(__linux__)
+        syscall(SYS_futex, address(), FUTEX_WAKE_PRIVATE, 1, nullptr, nullptr, 0);
+#else
+        // Taking the lock orders the wake up after a waiter checked the value
+        { std::lock_guard<std::mutex> guard{d_mutex}; }
+        d_condition.notify_one();
+#endif
+    }
+
+private:
+#if defined(__linux__)
+    static_assert(sizeof(std::atomic<int>) == sizeof(int),
+                  "A futex must be a plain 32 bit integer");
+
+    int* address() { return reinterpret_cast<int*>(&d_value); }
+#endif
+
+    std::atomic<int> d_value;
+#if !defined(__linux__)
+    std::mutex d_mutex;
+    std::condition_variable d_condition;
+#endif
+};
+
+} // namespace detail
+} // namespace resilient
@@ -0,0 +1,100 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <utility>
+
+namespace resilient {
+namespace detail {
+
+/**
+ * A bounded, lock-free queue for one producer thread and one consumer thread.
+ *
+ * Both `push()` and `pop()` are wait-free. Pushing to a full queue fails instead of waiting for
+ * the consumer, so the producer never blocks.
+ *
+ * The producer can be a different thread on each push, as long as the pushes are ordered by a
+ * happens-before relation (for example by a lock or an atomic flag).
+ *
+ * @tparam T The type of the elements. Must be default constructible and move assignable.
+ */
+template<typename T>
+class SpscQueue
+{
+public:
+    /**
+     * Create a queue holding at least `capacity` elements.
+     */
+    explicit SpscQueue(std::size_t capacity)
+    : d_mask(roundUpToPowerOfTwo(capacity) - 1)
+    , d_elements(new T[d_mask + 1])
+    , d_head(0)
+    , d_tail(0)
+    {
+    }
+
+    /**
+     * Add an element. Return false, dropping it, if the queue is full.
+     * Called by the producer.
+     */
+    bool push(T element)
+    {
+        const std::size_t tail = d_tail.load(std::memory_order_relaxed);
+        if (tail - d_head.load(std::memory_order_acquire) > d_mask) {
+            return false;
+        }
+        d_elements[tail & d_mask] = std::move(element);
+        d_tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * Remove the oldest element into `element`. Return false if the queue is empty.
+     * Called by the consumer.
+     */
+    bool pop(T& element)
+    {
+        const std::size_t head = d_head.load(std::memory_order_relaxed);
+        if (head == d_tail.load(std::memory_order_acquire)) {
+            return false;
+        }
+        element = std::move(d_elements[head & d_mask]);
+        d_head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * Whether the queue is empty.
+     * Called by the consumer.
+     */
+    bool empty() const
+    {
+        return d_head.load(std::memory_order_relaxed) == d_tail.load(std::memory_order_acquire);
+    }
+
+private:
+    static constexpr std::size_t CacheLineSize = 64;
+
+    static std::size_t roundUpToPowerOfTwo(std::size_t value)
+    {
+        std::size_t result = 1;
+        while (result < value) {
+            result <<= 1;
+        }
+        return result;
+    }
+
+    std::size_t d_mask;
+    std::unique_ptr<T[]> d_elements;
+    // The indexes are written by different threads, keep them on different cache lines.
+    // Padding instead of `alignas` keeps the queue allocatable with a plain `new` before C++17.
+    char d_headPadding[CacheLineSize];
+    std::atomic<std::size_t> d_head;
+    char d_tailPadding[CacheLineSize - sizeof(std::atomic<std::size_t>)];
+    std::atomic<std::size_t> d_tail;
+    char d_endPadding[CacheLineSize - sizeof(std::atomic<std::size_t>)];
+};
+
+} // namespace detail
+} // namespace resilient
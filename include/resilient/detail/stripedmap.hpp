@@ -0,0 +1,232 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <tuple>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace resilient {
+namespace detail {
+
+/**
+ * A concurrent map from keys to shared values, bounded in size, which forgets the values which
+ * were not used for a while.
+ *
+ * The keys are spread over a fixed number of stripes, each one a map protected by its own
+ * reader-writer lock. Looking up an existing key takes the lock of its stripe in shared mode,
+ * so lookups of any key run in parallel; only creating or evicting values locks a stripe
+ * exclusively.
+ *
+ * Each stripe holds at most `maxSize / stripes` values, rounded up. When a stripe is full the
+ * values idle for longer than `idleTimeout` are evicted first, then the least recently used.
+ * The values are held by `shared_ptr`, so evicting a value which is still in use only removes
+ * it from the map.
+ *
+ * @tparam Key The type of the keys.
+ * @tparam Value The type of the values.
+ * @tparam Clock The clock used to measure how long values have been idle.
+ * @tparam Hash The hash function of the keys.
+ */
+template<typename Key, typename Value, typename Clock, typename Hash = std::hash<Key>>
+class StripedMap
+{
+public:
+    using time_point = typename Clock::time_point;
+    using duration = typename Clock::duration;
+
+    StripedMap(std::size_t maxSize, std::size_t stripes, duration idleTimeout, Hash hash = Hash())
+    : d_stripes(std::max<std::size_t>(stripes, 1))
+    , d_maxStripeSize(
+          std::max<std::size_t>((maxSize + d_stripes.size() - 1) / d_stripes.size(), 1))
+    , d_idleTimeout(idleTimeout)
+    , d_hash(std::move(hash))
+    {
+    }
+
+    /**
+     * Return the value for the key, calling `create(key)` to make it if it's not in the map.
+     * `create` must return something convertible to `std::shared_ptr<Value>`, and is called with
+     * the lock of the stripe held.
+     */
+    template<typename Create>
+    std::shared_ptr<Value> getOrCreate(const Key& key, time_point now, Create&& create);
+
+    /**
+     * Return the value for the key, or null if it's not in the map.
+     */
+    std::shared_ptr<Value> find(const Key& key, time_point now);
+
+    /**
+     * Remove the value for the key. Return whether it was in the map.
+     */
+    bool erase(const Key& key);
+
+    /**
+     * Remove the values not used since `idleTimeout` before `now`. Return how many.
+     */
+    std::size_t evictIdle(time_point now);
+
+    /**
+     * The number of values in the map. Not exact while other threads modify it.
+     */
+    std::size_t size() const;
+
+private:
+    using rep = typename duration::rep;
+
+    struct Entry
+    {
+        Entry(std::shared_ptr<Value> value, time_point now)
+        : d_value(std::move(value)), d_lastAccess(now.time_since_epoch().count())
+        {
+        }
+
+        std::shared_ptr<Value> d_value;
+        // Updated under the shared lock by concurrent lookups.
+        std::atomic<rep> d_lastAccess;
+    };
+
+    struct Stripe
+    {
+        mutable std::shared_timed_mutex d_mutex;
+        std::unordered_map<Key, Entry, Hash> d_entries;
+    };
+
+    Stripe& stripeOf(const Key& key)
+    {
+        // The maps in the stripes use the low bits of the hash, so mix in the high ones: with an
+        // identity hash all the keys of a stripe would otherwise share the same low bits.
+        const std::uint64_t hash = static_cast<std::uint64_t>(d_hash(key));
+        return d_stripes[((hash * 0x9E3779B97F4A7C15ull) >> 32) % d_stripes.size()];
+    }
+
+    static std::shared_ptr<Value> touch(Entry& entry, time_point now)
+    {
+        entry.d_lastAccess.store(now.time_since_epoch().count(), std::memory_order_relaxed);
+        return entry.d_value;
+    }
+
+    // Make room for a new entry. Requires the exclusive lock of the stripe.
+    void makeRoom(Stripe& stripe, time_point now);
+    std::size_t evictIdle(Stripe& stripe, time_point now);
+
+    std::vector<Stripe> d_stripes;
+    std::size_t d_maxStripeSize;
+    duration d_idleTimeout;
+    Hash d_hash;
+};
+
+template<typename Key, typename Value, typename Clock, typename Hash>
+template<typename Create>
+std::shared_ptr<Value>
+StripedMap<Key, Value, Clock, Hash>::getOrCreate(const Key& key, time_point now, Create&& create)
+{
+    Stripe& stripe = stripeOf(key);
+    {
+        std::shared_lock<std::shared_timed_mutex> guard{stripe.d_mutex};
+        auto it = stripe.d_entries.find(key);
+        if (it != stripe.d_entries.end()) {
+            return touch(it->second, now);
+        }
+    }
+
+    std::unique_lock<std::shared_timed_mutex> guard{stripe.d_mutex};
+    // Another thread might have created it while we were not holding the lock
+    auto it = stripe.d_entries.find(key);
+    if (it != stripe.d_entries.end()) {
+        return touch(it->second, now);
+    }
+    makeRoom(stripe, now);
+    std::shared_ptr<Value> value{std::forward<Create>(create)(key)};
+    stripe.d_entries.emplace(std::piecewise_construct,
+                             std::forward_as_tuple(key),
+                             std::forward_as_tuple(value, now));
+    return value;
+}
+
+template<typename Key, typename Value, typename Clock, typename Hash>
+std::shared_ptr<Value> StripedMap<Key, Value, Clock, Hash>::find(const Key& key, time_point now)
+{
+    Stripe& stripe = stripeOf(key);
+    std::shared_lock<std::shared_timed_mutex> guard{stripe.d_mutex};
+    auto it = stripe.d_entries.find(key);
+    if (it == stripe.d_entries.end()) {
+        return nullptr;
+    }
+    return touch(it->second, now);
+}
+
+template<typename Key, typename Value, typename Clock, typename Hash>
+bool StripedMap<Key, Value, Clock, Hash>::erase(const Key& key)
+{
+    Stripe& stripe = stripeOf(key);
+    std::unique_lock<std::shared_timed_mutex> guard{stripe.d_mutex};
+    return stripe.d_entries.erase(key) > 0;
+}
+
+template<typename Key, typename Value, typename Clock, typename Hash>
+std::size_t StripedMap<Key, Value, Clock, Hash>::evictIdle(time_point now)
+{
+    std::size_t evicted = 0;
+    for (Stripe& stripe : d_stripes) {
+        std::unique_lock<std::shared_timed_mutex> guard{stripe.d_mutex};
+        evicted += evictIdle(stripe, now);
+    }
+    return evicted;
+}
+
+template<typename Key, typename Value, typename Clock, typename Hash>
+std::size_t StripedMap<Key, Value, Clock, Hash>::size() const
+{
+    std::size_t result = 0;
+    for (const Stripe& stripe : d_stripes) {
+        std::shared_lock<std::shared_timed_mutex> guard{stripe.d_mutex};
+        result += stripe.d_entries.size();
+    }
+    return result;
+}
+
+template<typename Key, typename Value, typename Clock, typename Hash>
+void StripedMap<Key, Value, Clock, Hash>::makeRoom(Stripe& stripe, time_point now)
+{
+    if (stripe.d_entries.size() < d_maxStripeSize or evictIdle(stripe, now) > 0) {
+        return;
+    }
+    // Nothing is idle: drop the least recently used
+    auto oldest = std::min_element(
+        stripe.d_entries.begin(), stripe.d_entries.end(), [](const auto& lhs, const auto& rhs) {
+            return lhs.second.d_lastAccess.load(std::memory_order_relaxed)
+                   < rhs.second.d_lastAccess.load(std::memory_order_relaxed);
+        });
+    stripe.d_entries.erase(oldest);
+}
+
+template<typename Key, typename Value, typename Clock, typename Hash>
+std::size_t StripedMap<Key, Value, Clock, Hash>::evictIdle(Stripe& stripe, time_point now)
+{
+    std::size_t evicted = 0;
+    for (auto it = stripe.d_entries.begin(); it != stripe.d_entries.end();) {
+        const time_point lastAccess{
+            duration(it->second.d_lastAccess.load(std::memory_order_relaxed))};
+        if (lastAccess + d_idleTimeout < now) {
+            it = stripe.d_entries.erase(it);
+            evicted++;
+        }
+        else
+        {
+            ++it;
+        }
+    }
+    return evicted;
+}
+
+} // namespace detail
+} // namespace resilient
@@ -0,0 +1,253 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <utility>
+#include <vector>
+
+namespace resilient {
+namespace detail {
+
+/**
+ * A timer linked in a slot of a `HierarchicalTimerWheel`. The nodes are reused: the generation
+ * changes every time the timer expires or is cancelled, so that a stale handle can be detected.
+ */
+struct TimerNode
+{
+    std::function<void()> d_function;
+    std::uint64_t d_expiry = 0;
+    std::uint64_t d_generation = 0;
+    bool d_pending = false;
+    // The head of the list of the slot the timer is linked in
+    TimerNode** d_slot = nullptr;
+    TimerNode* d_previous = nullptr;
+    TimerNode* d_next = nullptr;
+};
+
+/**
+ * A hashed hierarchical timer wheel counting time in ticks.
+ *
+ * There are `Levels` wheels of `Slots` slots each. A timer is linked in the slot of the lowest
+ * level which covers its expiry: the slots of level `L` span `Slots^L` ticks each. When the
+ * lowest level wraps around, the next slot of the level above is emptied and its timers are
+ * linked again in the lower levels, closer to their expiry. Inserting and cancelling a timer
+ * take constant time, and advancing by a tick takes constant time plus the expired timers, plus
+ * the timers moved to a lower level (which each timer is at most `Levels - 1` times).
+ *
+ * Timers further than `Slots^Levels` ticks are kept in the highest level and moved again until
+ * they are close enough.
+ *
+ * It's not thread safe: it must be protected by a lock.
+ */
+class HierarchicalTimerWheel
+{
+public:
+    static constexpr unsigned SlotBits = 8;
+    static constexpr std::size_t Slots = std::size_t(1) << SlotBits;
+    static constexpr std::size_t Levels = 4;
+
+    HierarchicalTimerWheel() : d_now(0), d_size(0), d_free(nullptr)
+    {
+        for (auto& level : d_slots) {
+            for (auto& slot : level) {
+                slot = nullptr;
+            }
+        }
+    }
+
+    HierarchicalTimerWheel(const HierarchicalTimerWheel&) = delete;
+    HierarchicalTimerWheel& operator=(const HierarchicalTimerWheel&) = delete;
+
+    /**
+     * The current tick: the timers expiring up to it have expired.
+     */
+    std::uint64_t now() const { return d_now; }
+
+    /**
+     * The number of timers which didn't expire and were not cancelled.
+     */
+    std::size_t size() const { return d_size; }
+
+    bool empty() const { return d_size == 0; }
+
+    /**
+     * The next tick at which `advance()` has something to do: a timer of the lowest level
+     * expires, or the lowest level wraps around and the timers of the higher levels move down.
+     * Advancing to an earlier tick only moves the current tick.
+     */
+    std::uint64_t nextEvent() const
+    {
+        // The timers of the lowest level after the wrap around are in the slots before `d_now`
+        const std::uint64_t wrapAround = (d_now | (Slots - 1)) + 1;
+        for (std::uint64_t tick = d_now + 1; tick < wrapAround; tick++) {
+            if (d_slots[0][slotIndex(tick, 0)] != nullptr) {
+                return tick;
+            }
+        }
+        return wrapAround;
+    }
+
+    /**
+     * Add a timer expiring at the tick `expiry`, or at the next tick if it's already past.
+     * The node stays valid until the wheel is destroyed.
+     */
+    TimerNode& insert(std::uint64_t expiry, std::function<void()> function)
+    {
+        TimerNode& node = allocate();
+        node.d_function = std::move(function);
+        node.d_expiry = expiry > d_now ? expiry : d_now + 1;
+        node.d_pending = true;
+        link(node);
+        d_size++;
+        return node;
+    }
+
+    /**
+     * Cancel the timer of the node if it's still the timer of the given generation.
+     *
+     * @return Whether the timer was cancelled before expiring.
+     */
+    bool cancel(TimerNode& node, std::uint64_t generation)
+    {
+        if (node.d_generation != generation or not node.d_pending) {
+            return false;
+        }
+        unlink(node);
+        d_size--;
+        release(node);
+        return true;
+    }
+
+    /**
+     * Advance the current tick up to `tick`, appending the functions of the expired timers to
+     * `expired`. The timers expiring at an earlier tick come first.
+     */
+    void advance(std::uint64_t tick, std::vector<std::function<void()>>& expired)
+    {
+        while (d_now < tick) {
+            if (d_size == 0) {
+                // Nothing can expire: no need to visit the slots
+                d_now = tick;
+                return;
+            }
+            d_now++;
+            // Move down the timers of the higher levels first, as they can land in the
+            // current slot of a lower level
+            std::size_t levels = 1;
+            while (levels < Levels and slotIndex(d_now, levels - 1) == 0) {
+                levels++;
+            }
+            for (std::size_t level = levels - 1; level > 0; level--) {
+                cascade(level);
+            }
+            expire(expired);
+        }
+    }
+
+private:
+    static std::size_t slotIndex(std::uint64_t tick, std::size_t level)
+    {
+        return static_cast<std::size_t>(tick >> (level * SlotBits)) & (Slots - 1);
+    }
+
+    TimerNode& allocate()
+    {
+        if (d_free == nullptr) {
+            d_nodes.emplace_back();
+            return d_nodes.back();
+        }
+        TimerNode& node = *d_free;
+        d_free = node.d_next;
+        return node;
+    }
+
+    void release(TimerNode& node)
+    {
+        node.d_function = nullptr;
+        node.d_generation++;
+        node.d_pending = false;
+        node.d_slot = nullptr;
+        node.d_previous = nullptr;
+        node.d_next = d_free;
+        d_free = &node;
+    }
+
+    TimerNode*& slotOf(const TimerNode& node)
+    {
+        const std::uint64_t delta = node.d_expiry - d_now;
+        std::size_t level = 0;
+        while (level + 1 < Levels and (delta >> ((level + 1) * SlotBits)) != 0) {
+            level++;
+        }
+        // Past the range of the highest level: wait in the slot expiring last
+        const std::uint64_t expiry = (delta >> (Levels * SlotBits)) != 0
+                                         ? d_now + (std::uint64_t(1) << (Levels * SlotBits)) - 1
+                                         : node.d_expiry;
+        return d_slots[level][slotIndex(expiry, level)];
+    }
+
+    void link(TimerNode& node)
+    {
+        TimerNode*& head = slotOf(node);
+        node.d_slot = &head;
+        node.d_previous = nullptr;
+        node.d_next = head;
+        if (head != nullptr) {
+            head->d_previous = &node;
+        }
+        head = &node;
+    }
+
+    void unlink(TimerNode& node)
+    {
+        if (node.d_previous != nullptr) {
+            node.d_previous->d_next = node.d_next;
+        }
+        else
+        {
+            *node.d_slot = node.d_next;
+        }
+        if (node.d_next != nullptr) {
+            node.d_next->d_previous = node.d_previous;
+        }
+    }
+
+    TimerNode* takeSlot(std::size_t level, std::size_t index)
+    {
+        TimerNode* head = d_slots[level][index];
+        d_slots[level][index] = nullptr;
+        return head;
+    }
+
+    void cascade(std::size_t level)
+    {
+        for (TimerNode* node = takeSlot(level, slotIndex(d_now, level)); node != nullptr;) {
+            TimerNode* next = node->d_next;
+            link(*node);
+            node = next;
+        }
+    }
+
+    void expire(std::vector<std::function<void()>>& expired)
+    {
+        for (TimerNode* node = takeSlot(0, slotIndex(d_now, 0)); node != nullptr;) {
+            TimerNode* next = node->d_next;
+            expired.push_back(std::move(node->d_function));
+            d_size--;
+            release(*node);
+            node = next;
+        }
+    }
+
+    std::uint64_t d_now;
+    std::size_t d_size;
+    TimerNode* d_slots[Levels][Slots];
+    // The nodes never move, so that the handles stay valid
+    std::deque<TimerNode> d_nodes;
+    TimerNode* d_free;
+};
+
+} // namespace detail
+} // namespace resilient
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <condition_variable>
+
+namespace resilient {
+namespace detail {
+
+/**
+ * A thread waiting to be handed a permit. It lives on the stack of the waiting thread, and it's
+ * linked in a `WaiterQueue` while it waits.
+ *
+ * The waiter waits on its own condition variable until `d_granted` is set, with the lock
+ * protecting the queue held. Whoever grants the permit must notify with the lock still held,
+ * so that the waiter can't return and destroy the node before.
+ */
+struct Waiter
+{
+    std::condition_variable d_condition;
+    bool d_granted = false;
+    Waiter* d_older = nullptr;
+    Waiter* d_newer = nullptr;
+};
+
+/**
+ * An intrusive FIFO queue of waiters. It doesn't allocate, and removing a waiter which timed
+ * out from the middle takes constant time. It's not thread safe: it must be protected by a lock.
+ */
+class WaiterQueue
+{
+public:
+    WaiterQueue() : d_oldest(nullptr), d_newest(nullptr) {}
+
+    WaiterQueue(const WaiterQueue&) = delete;
+    WaiterQueue& operator=(const WaiterQueue&) = delete;
+
+    bool empty() const { return d_oldest == nullptr; }
+
+    /**
+     * The waiter which has been waiting the longest. The queue must not be empty.
+     */
+    Waiter& oldest() const { return *d_oldest; }
+
+    void push(Waiter& waiter)
+    {
+        waiter.d_older = d_newest;
+        waiter.d_newer = nullptr;
+        if (d_newest != nullptr) {
+            d_newest->d_newer = &waiter;
+        }
+        else
+        {
+            d_oldest = &waiter;
+        }
+        d_newest = &waiter;
+    }
+
+    void remove(Waiter& waiter)
+    {
+        if (waiter.d_older != nullptr) {
+            waiter.d_older->d_newer = waiter.d_newer;
+        }
+        else
+        {
+            d_oldest = waiter.d_newer;
+        }
+        if (waiter.d_newer != nullptr) {
+            waiter.d_newer->d_older = waiter.d_older;
+        }
+        else
+        {
+            d_newest = waiter.d_older;
+        }
+    }
+
+    /**
+     * Remove the oldest waiter and hand it the permit. The queue must not be empty.
+     */
+    void grantOldest()
+    {
+        Waiter& waiter = *d_oldest;
+        remove(waiter);
+        waiter.d_granted = true;
+        waiter.d_condition.notify_one();
+    }
+
+private:
+    Waiter* d_oldest;
+    Waiter* d_newest;
+};
+
+} // namespace detail
+} // namespace resilient
@@ -1,6 +1,8 @@
 #pragma once
 
+#include <chrono>
 #include <memory>
+#include <type_traits>
 #include <utility>
 
 #include <resilient/detail/invoke.hpp>
@@ -44,6 +46,27 @@ public:
      */
     virtual void registerSuccess() = 0;
 
+    /**
+     * @brief Whether the algorithm needs to know how long each execution took.
+     *
+     * When true the `Circuitbreaker` measures the executions and calls `registerTimedFailure()`
+     * and `registerTimedSuccess()` instead of `registerFailure()` and `registerSuccess()`.
+     * This is checked only once, when the `Circuitbreaker` is constructed.
+     */
+    virtual bool needsCallDuration() const { return false; }
+
+    /**
+     * @brief Notify the algorithm that an execution resulted in failure after running for
+     *        the given duration.
+     */
+    virtual void registerTimedFailure(std::chrono::nanoseconds) { registerFailure(); }
+
+    /**
+     * @brief Notify the algorithm that an execution resulted in success after running for
+     *        the given duration.
+     */
+    virtual void registerTimedSuccess(std::chrono::nanoseconds) { registerSuccess(); }
+
     virtual ~ICircuitbreakerStrategy() {}
 };
 
@@ -59,26 +82,55 @@ public:
  *
  * This keeps limit the performance impact a dependency can cause to the whole system.
  *
+ * When the strategy is a concrete, `final` class the compiler can inline its calls.
+ * `Circuitbreaker` is the type-erased version, which accepts any strategy.
+ *
+ * @tparam Strategy: the strategy to use. Must derive from ICircuitbreakerStrategy.
  */
-class Circuitbreaker
+template<typename Strategy>
+class BasicCircuitbreaker
 {
 private:
+    static_assert(std::is_convertible<Strategy*, ICircuitbreakerStrategy*>::value,
+                  "The strategy must derive from ICircuitbreakerStrategy.");
+
     template<typename Callable, typename... Args>
     using return_type_t = add_failure_to_noref_failable_t<forward_result_of_t<Callable, Args...>,
                                                           CircuitbreakerIsOpen>;
 
+    using time_point = std::chrono::steady_clock::time_point;
+
+    // Register a failure if the task throws: a call the strategy allowed must always be
+    // registered, or the probe slot it took while half-open would never be released.
+    struct ThrowGuard
+    {
+        ~ThrowGuard()
+        {
+            if (d_armed) {
+                d_circuitbreaker.registerResult(true, d_start);
+            }
+        }
+
+        BasicCircuitbreaker& d_circuitbreaker;
+        time_point d_start;
+        bool d_armed;
+    };
+
 public:
     /**
      * @brief Construct a `Circuitbreaker` with the given strategy.
      */
-    Circuitbreaker(std::unique_ptr<ICircuitbreakerStrategy>&& strategy)
-    : d_strategy(std::move(strategy))
+    BasicCircuitbreaker(std::unique_ptr<Strategy>&& strategy)
+    : d_strategy(std::move(strategy)), d_measureDuration(d_strategy->needsCallDuration())
     {
     }
 
     /**
      * @brief Execute the task if the `Circuitbreaker` is not open.
      *
+     * If the task throws the execution is registered as a failure, and the exception is
+     * propagated.
+     *
      * @param callable The task to execute
      * @param args... The arguments to the task
      * @return The result of invoking the task, or CircuitbreakerIsOpen if the task was not executed.
@@ -90,17 +142,17 @@ public:
             return from_failure<return_type_t<Callable, Args...>>(CircuitbreakerIsOpen());
         }
 
+        // Reading the clock is not free, so we do it only if the strategy needs it.
+        const time_point start = d_measureDuration ? std::chrono::steady_clock::now()
+                                                   : time_point();
+
+        ThrowGuard guard{*this, start, true};
         // Invoke the task and keep the result
         decltype(auto) result{
             detail::invoke(std::forward<Callable>(callable), std::forward<Args>(args)...)};
+        guard.d_armed = false;
 
-        if (holds_failure(result)) {
-            d_strategy->registerFailure();
-        }
-        else
-        {
-            d_strategy->registerSuccess();
-        }
+        registerResult(holds_failure(result), start);
 
         // Create a Failable from the returned failable (which is narrower than the one returned
         // by this method).
@@ -110,7 +162,36 @@ public:
     }
 
 private:
-    std::unique_ptr<ICircuitbreakerStrategy> d_strategy;
+    void registerResult(bool failed, time_point start)
+    {
+        if (d_measureDuration) {
+            const auto duration = std::chrono::steady_clock::now() - start;
+            if (failed) {
+                d_strategy->registerTimedFailure(duration);
+            }
+            else
+            {
+                d_strategy->registerTimedSuccess(duration);
+            }
+        }
+        else if (failed)
+        {
+            d_strategy->registerFailure();
+        }
+        else
+        {
+            d_strategy->registerSuccess();
+        }
+    }
+
+    std::unique_ptr<Strategy> d_strategy;
+    bool d_measureDuration;
 };
 
+/**
+ * @ingroup Policy
+ * @brief A `BasicCircuitbreaker` which accepts any strategy, calling it through its interface.
+ */
+using Circuitbreaker = BasicCircuitbreaker<ICircuitbreakerStrategy>;
+
 } // namespace resilient
\ No newline at end of file
@@ -0,0 +1,113 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <utility>
+
+#include <resilient/detail/stripedmap.hpp>
+#include <resilient/policy/circuitbreaker.hpp>
+
+namespace resilient {
+
+/**
+ * @ingroup Policy
+ * @brief Share circuit breakers by key, for example one for each endpoint of a dependency.
+ * @related resilient::BasicCircuitbreaker
+ *
+ * The first time a key is requested its strategy is created with the factory, and the same
+ * circuit breaker is returned for the key until it is evicted.
+ *
+ * Lookups of existing keys only take a shared lock on a fraction of the registry, so they
+ * can run in parallel from many threads. Creating a circuit breaker locks only that fraction.
+ *
+ * To keep the memory bounded the registry holds at most about `maxSize` circuit breakers.
+ * Circuit breakers which were not requested for `idleTimeout` are evicted when space is needed
+ * or when `evictIdle()` is called; if none is idle the least recently requested is evicted.
+ * The registry returns shared pointers, so evicting a circuit breaker somebody is using only
+ * means that the next request for its key creates a new one.
+ *
+ * @tparam Key The type of the keys. Must be hashable by `Hash` and equality comparable.
+ * @tparam Strategy The strategy of the circuit breakers. Must derive from ICircuitbreakerStrategy.
+ * @tparam Clock The kind of clock to use when measuring how long circuit breakers were idle.
+ * @tparam Hash The hash function of the keys.
+ */
+template<typename Key,
+         typename Strategy = ICircuitbreakerStrategy,
+         typename Clock = std::chrono::steady_clock,
+         typename Hash = std::hash<Key>>
+class CircuitbreakerRegistry
+{
+public:
+    /**
+     * @brief The type of the circuit breakers in the registry.
+     */
+    using circuitbreaker_type = BasicCircuitbreaker<Strategy>;
+
+    /**
+     * @brief The type of the function which creates the strategy for a key.
+     */
+    using factory_type = std::function<std::unique_ptr<Strategy>(const Key&)>;
+
+    /**
+     * @brief Construct a new CircuitbreakerRegistry object.
+     *
+     * @param factory Called to create the strategy of the circuit breaker of a new key.
+     * @param maxSize The maximum number of circuit breakers to keep.
+     * @param idleTimeout After how long without being requested a circuit breaker can be evicted.
+     * @param stripes In how many independently locked parts to divide the registry.
+     * @param clock An instance of the clock to use to measure time. Defaults to a default initialized one.
+     */
+    CircuitbreakerRegistry(factory_type factory,
+                           std::size_t maxSize,
+                           std::chrono::microseconds idleTimeout,
+                           std::size_t stripes = 16,
+                           Clock clock = Clock())
+    : d_factory(std::move(factory))
+    , d_circuitbreakers(maxSize,
+                        stripes,
+                        std::chrono::duration_cast<typename Clock::duration>(idleTimeout))
+    , d_clock(std::move(clock))
+    {
+    }
+
+    /**
+     * @brief Get the circuit breaker for the key, creating it if needed.
+     */
+    std::shared_ptr<circuitbreaker_type> get(const Key& key)
+    {
+        return d_circuitbreakers.getOrCreate(key, d_clock.now(), [this](const Key& newKey) {
+            return std::make_shared<circuitbreaker_type>(d_factory(newKey));
+        });
+    }
+
+    /**
+     * @brief Remove the circuit breaker for the key.
+     *
+     * @return Whether there was a circuit breaker for the key.
+     */
+    bool remove(const Key& key) { return d_circuitbreakers.erase(key); }
+
+    /**
+     * @brief Remove all the circuit breakers which were not requested for `idleTimeout`.
+     *
+     * Idle circuit breakers are also evicted when space is needed, calling this periodically
+     * releases their memory earlier.
+     *
+     * @return How many circuit breakers were removed.
+     */
+    std::size_t evictIdle() { return d_circuitbreakers.evictIdle(d_clock.now()); }
+
+    /**
+     * @brief The number of circuit breakers in the registry.
+     */
+    std::size_t size() const { return d_circuitbreakers.size(); }
+
+private:
+    factory_type d_factory;
+    detail::StripedMap<Key, circuitbreaker_type, Clock, Hash> d_circuitbreakers;
+    Clock d_clock;
+};
+
+} // namespace resilient
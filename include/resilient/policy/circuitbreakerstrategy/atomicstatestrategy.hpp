@@ -0,0 +1,459 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+
+#include <resilient/policy/circuitbreaker.hpp>
+#include <resilient/policy/circuitbreakerstrategy/heldprobes.hpp>
+#include <resilient/policy/circuitbreakerstrategy/statechange.hpp>
+
+namespace resilient {
+namespace detail {
+
+/**
+ * Lock-free state machine shared by the lock-free circuit breaker strategies.
+ *
+ * Implements the Closed (LetThrough), Open (Intercept) and Half-Open (TryLetThrough) states,
+ * leaving to `Derived` the decision of when to trip while the circuit breaker is closed.
+ *
+ * `Derived` must implement:
+ *  - `void closedFailure(time_point now)`: a call failed while closed.
+ *    Call `tripIfClosed(now)` to open the circuit breaker.
+ *  - `void closedSuccess()`: a call succeeded while closed.
+ *  - `void resetClosed(time_point now)`: the circuit breaker is closing again after recovering.
+ *    No thread can trip it while this runs.
+ *  - `bool shouldTrip()`: whether the calls recorded since `resetClosed()` should trip it.
+ *
+ * Strategies which need the duration of the calls override the timed methods of
+ * `ICircuitbreakerStrategy` and call `registerFailureWith(duration)` and
+ * `registerSuccessWith(duration)`, which pass the duration to the hooks after `now`.
+ *
+ * While half-open at most `maxProbes` calls are allowed at the same time: a probe slot is taken
+ * by `allowCall()` and released when the call is registered. Only the calls which took a slot
+ * of the current half-open period release it and count towards recovering: the others were
+ * allowed before the trip, so their result says nothing about the recovery.
+ * A slot is released only if the call is registered on the thread which took it. If all the
+ * slots stay taken for `tripDuration` without any probe starting or ending, a new half-open
+ * period starts: the slots are reclaimed and the lost probes are ignored.
+ *
+ * Only one thread at a time can switch state, so the state changes can be pushed to a
+ * single-producer queue. No thread ever waits for another: a probe registered while another
+ * thread completes the switch to half-open records its result in the state word, and the
+ * switching thread performs the trip or the recovery it requires before publishing the state.
+ */
+template<typename Derived, typename Clock>
+class AtomicStateStrategy : public ICircuitbreakerStrategy
+{
+public:
+    bool allowCall() override;
+    void registerFailure() override { registerFailureWith(); }
+    void registerSuccess() override { registerSuccessWith(); }
+
+    /**
+     * @brief Push the state changes of the strategy to the queue.
+     *
+     * Must be called before the strategy is used by multiple threads.
+     */
+    void notifyStateChangesTo(std::shared_ptr<StateChangeQueue> queue)
+    {
+        d_stateChanges = std::move(queue);
+    }
+
+protected:
+    using time_point = typename Clock::time_point;
+
+    // Register a call, forwarding `args...` to the hooks of `Derived`.
+    template<typename... Args>
+    void registerFailureWith(Args&&... args);
+    template<typename... Args>
+    void registerSuccessWith(Args&&... args);
+
+    AtomicStateStrategy(std::chrono::microseconds tripDuration,
+                        unsigned long recoverSuccesses,
+                        unsigned long maxProbes,
+                        Clock clock);
+
+    // Open the circuit breaker if it's closed.
+    // If a thread is closing it, that thread trips it afterwards if `shouldTrip()`.
+    void tripIfClosed(time_point now);
+
+    Clock d_clock;
+
+private:
+    using rep = typename time_point::duration::rep;
+    using word = std::uint64_t;
+
+    // Layout of the state word:
+    //  - bits [0, 2)   the state
+    //  - bit 2         set while the thread which switched state completes the switch
+    //  - bits [3, 35)  the successes in TryLetThrough
+    //  - bit 35        set by a probe which failed while the switch to TryLetThrough is pending
+    //  - bits [36, 64) the probes in flight in TryLetThrough, when they are limited
+    //
+    // Keeping the probes in the state word means they are released all at once when the state
+    // changes, and a slot can never be taken for a state which is already gone.
+    // While the pending bit is set no other thread can switch state, so the end of the trip
+    // always belongs to the current trip once the bit is cleared.
+    enum : word
+    {
+        LetThrough = 0,
+        Intercept = 1,
+        TryLetThrough = 2,
+        StateMask = 0x3,
+        Pending = 0x4,
+        CounterShift = 3,
+        CounterIncrement = word(1) << CounterShift,
+        TripRequested = word(1) << 35,
+        ProbeShift = 36,
+        ProbeIncrement = word(1) << ProbeShift,
+        // Limits above this can't be counted, so they are the same as no limit
+        MaxProbeLimit = word(1) << (64 - ProbeShift - 1)
+    };
+
+    static word stateOf(word value) { return value & StateMask; }
+    static bool isPending(word value) { return value & Pending; }
+    static word counterOf(word value) { return (value >> CounterShift) & 0xffffffff; }
+    static word probesOf(word value) { return value >> ProbeShift; }
+
+    bool limitsProbes() const { return d_maxProbes < MaxProbeLimit; }
+
+    static CircuitbreakerState publicStateOf(word state)
+    {
+        return state == LetThrough ? CircuitbreakerState::Closed
+                                   : state == Intercept ? CircuitbreakerState::Open
+                                                        : CircuitbreakerState::HalfOpen;
+    }
+
+    Derived& derived() { return static_cast<Derived&>(*this); }
+
+    // Whether the successes counted in `value` recover the circuit breaker.
+    bool recovers(word value) const
+    {
+        return counterOf(value) > 0 and counterOf(value) >= d_successesBeforeRecovering;
+    }
+
+    // Complete a switch from `from` to `to`, clearing the pending bit.
+    // Performs first the trip or the recovery the probes registered meanwhile require.
+    void completeSwitch(word from, word to);
+
+    // Record the result of a probe while the switch to TryLetThrough is pending.
+    // Return false if the switch completed first, updating `current`.
+    bool tryRecordPending(word& current, bool failed);
+
+    // Switch to Intercept if the state is still `current`.
+    // Return false if another thread changed the state first, updating `current`.
+    bool tryTrip(word& current, time_point now);
+
+    // The half-open period of the slot the call being registered took, or 0.
+    std::uint64_t releaseHeldProbe() const
+    {
+        return limitsProbes() ? HeldProbes::release(this) : 0;
+    }
+
+    time_point lastProbeActivity() const
+    {
+        return time_point{
+            typename time_point::duration(d_lastProbeActivity.load(std::memory_order_acquire))};
+    }
+
+    // Whether a call which took a slot of `heldPeriod` is a probe of the current half-open
+    // period. Always true when the probes are not limited.
+    // Must be called after reading a state which is not pending.
+    bool isProbe(std::uint64_t heldPeriod) const
+    {
+        return not limitsProbes() or heldPeriod == d_period.load(std::memory_order_acquire);
+    }
+
+    // Clear the pending bit after switching to LetThrough.
+    void completeClosing();
+
+    std::chrono::microseconds d_tripDuration;
+    unsigned long d_successesBeforeRecovering;
+    unsigned long d_maxProbes;
+
+    std::atomic<word> d_state;
+    std::atomic<rep> d_endOfTrip;
+    // The id of the current half-open period, written before clearing the pending bit
+    std::atomic<std::uint64_t> d_period;
+    // When a probe slot was last taken or released, to reclaim the slots of lost probes
+    std::atomic<rep> d_lastProbeActivity;
+
+    // Written only by the thread which set the pending bit
+    std::shared_ptr<StateChangeQueue> d_stateChanges;
+};
+
+template<typename Derived, typename Clock>
+AtomicStateStrategy<Derived, Clock>::AtomicStateStrategy(std::chrono::microseconds tripDuration,
+                                                         unsigned long recoverSuccesses,
+                                                         unsigned long maxProbes,
+                                                         Clock clock)
+: d_clock(std::move(clock))
+, d_tripDuration(tripDuration)
+, d_successesBeforeRecovering(recoverSuccesses)
+, d_maxProbes(maxProbes)
+, d_state(LetThrough)
+, d_endOfTrip(0)
+, d_period(0)
+, d_lastProbeActivity(0)
+{
+    if (maxProbes == 0) {
+        throw std::invalid_argument("At least one probe must be allowed to recover");
+    }
+}
+
+template<typename Derived, typename Clock>
+bool AtomicStateStrategy<Derived, Clock>::allowCall()
+{
+    word current = d_state.load(std::memory_order_acquire);
+    for (;;) {
+        word next;
+        bool switching = false;
+        if (stateOf(current) == Intercept) {
+            if (isPending(current)) {
+                return false;
+            }
+            time_point endOfTrip{
+                typename time_point::duration(d_endOfTrip.load(std::memory_order_acquire))};
+            const time_point now = d_clock.now();
+            if (now < endOfTrip) {
+                return false;
+            }
+            // The trip is over: this call is the first probe.
+            next = TryLetThrough | Pending | (limitsProbes() ? word(ProbeIncrement) : word(0));
+            switching = true;
+            d_lastProbeActivity.store(now.time_since_epoch().count(), std::memory_order_release);
+        }
+        else if (stateOf(current) == TryLetThrough and limitsProbes())
+        {
+            // While pending the period of the slots is not published yet
+            if (isPending(current)) {
+                return false;
+            }
+            const time_point now = d_clock.now();
+            if (probesOf(current) < d_maxProbes) {
+                next = current + ProbeIncrement;
+            }
+            else if (now >= lastProbeActivity() + d_tripDuration)
+            {
+                // The probes were lost: start a new period, where this call is the first probe
+                next = TryLetThrough | Pending | ProbeIncrement;
+                switching = true;
+            }
+            else
+            {
+                return false;
+            }
+            // Before taking the slot, so that the slots are not reclaimed right after
+            d_lastProbeActivity.store(now.time_since_epoch().count(), std::memory_order_release);
+        }
+        else
+        {
+            return true;
+        }
+        // Read before taking the slot: if the period changed since, the slot is not released
+        // by this call, which can only make the limit stricter.
+        const std::uint64_t period = d_period.load(std::memory_order_acquire);
+        // If we lose the race another thread switched state or took a probe, check it again.
+        if (d_state.compare_exchange_weak(
+                current, next, std::memory_order_acq_rel, std::memory_order_acquire)) {
+            if (switching) {
+                if (limitsProbes()) {
+                    const std::uint64_t newPeriod = HeldProbes::newPeriod();
+                    d_period.store(newPeriod, std::memory_order_release);
+                    HeldProbes::take(this, newPeriod);
+                }
+                completeSwitch(stateOf(current), TryLetThrough);
+            }
+            else
+            {
+                HeldProbes::take(this, period);
+            }
+            return true;
+        }
+    }
+}
+
+template<typename Derived, typename Clock>
+template<typename... Args>
+void AtomicStateStrategy<Derived, Clock>::registerFailureWith(Args&&... args)
+{
+    const time_point now = d_clock.now();
+
+    const std::uint64_t heldPeriod = releaseHeldProbe();
+    word current = d_state.load(std::memory_order_acquire);
+    if (stateOf(current) == LetThrough) {
+        derived().closedFailure(now, std::forward<Args>(args)...);
+        return;
+    }
+    while (stateOf(current) == TryLetThrough) {
+        if (isPending(current)) {
+            if (tryRecordPending(current, true)) {
+                return;
+            }
+        }
+        else if (not isProbe(heldPeriod))
+        {
+            return;
+        }
+        else if (tryTrip(current, now))
+        {
+            return;
+        }
+    }
+}
+
+template<typename Derived, typename Clock>
+template<typename... Args>
+void AtomicStateStrategy<Derived, Clock>::registerSuccessWith(Args&&... args)
+{
+    const std::uint64_t heldPeriod = releaseHeldProbe();
+    word current = d_state.load(std::memory_order_acquire);
+    if (stateOf(current) == LetThrough) {
+        derived().closedSuccess(std::forward<Args>(args)...);
+        return;
+    }
+    while (stateOf(current) == TryLetThrough) {
+        if (isPending(current)) {
+            if (tryRecordPending(current, false)) {
+                return;
+            }
+            continue;
+        }
+        if (not isProbe(heldPeriod)) {
+            return;
+        }
+        word next = current + CounterIncrement;
+        if (limitsProbes()) {
+            next -= ProbeIncrement;
+            d_lastProbeActivity.store(d_clock.now().time_since_epoch().count(),
+                                      std::memory_order_release);
+        }
+        const bool recovered = recovers(next);
+        if (recovered) {
+            next = LetThrough | Pending;
+        }
+        if (d_state.compare_exchange_weak(
+                current, next, std::memory_order_acq_rel, std::memory_order_acquire)) {
+            if (recovered) {
+                derived().resetClosed(d_clock.now());
+                completeClosing();
+            }
+            return;
+        }
+    }
+}
+
+template<typename Derived, typename Clock>
+void AtomicStateStrategy<Derived, Clock>::tripIfClosed(time_point now)
+{
+    // While pending the thread closing the circuit breaker checks `shouldTrip()`
+    // after clearing the bit, so the trip can't be lost.
+    word current = d_state.load(std::memory_order_acquire);
+    while (stateOf(current) == LetThrough and not isPending(current)) {
+        if (tryTrip(current, now)) {
+            return;
+        }
+    }
+}
+
+template<typename Derived, typename Clock>
+bool AtomicStateStrategy<Derived, Clock>::tryTrip(word& current, time_point now)
+{
+    const word from = stateOf(current);
+    if (d_state.compare_exchange_weak(current,
+                                      Intercept | Pending,
+                                      std::memory_order_acq_rel,
+                                      std::memory_order_acquire))
+    {
+        d_endOfTrip.store((now + d_tripDuration).time_since_epoch().count(),
+                          std::memory_order_release);
+        completeSwitch(from, Intercept);
+        return true;
+    }
+    return false;
+}
+
+template<typename Derived, typename Clock>
+void AtomicStateStrategy<Derived, Clock>::completeClosing()
+{
+    completeSwitch(TryLetThrough, LetThrough);
+
+    // Failures registered while we were closing might already require a trip.
+    if (derived().shouldTrip()) {
+        tripIfClosed(d_clock.now());
+    }
+}
+
+template<typename Derived, typename Clock>
+bool AtomicStateStrategy<Derived, Clock>::tryRecordPending(word& current, bool failed)
+{
+    // While pending nobody can take a slot of the new period: the call is not one of its probes
+    if (limitsProbes()) {
+        return true;
+    }
+    word next = current;
+    if (failed) {
+        next |= TripRequested;
+    }
+    else if (not recovers(current))
+    {
+        next += CounterIncrement;
+    }
+    return next == current
+           or d_state.compare_exchange_weak(
+               current, next, std::memory_order_acq_rel, std::memory_order_acquire);
+}
+
+template<typename Derived, typename Clock>
+void AtomicStateStrategy<Derived, Clock>::completeSwitch(word from, word to)
+{
+    // The pending bit makes this thread the only producer of the queue.
+    // A new half-open period is not a change of state.
+    if (d_stateChanges and from != to) {
+        d_stateChanges->push({this, publicStateOf(from), publicStateOf(to)});
+    }
+    word current = d_state.load(std::memory_order_acquire);
+    for (;;) {
+        if (stateOf(current) == TryLetThrough and (current & TripRequested)) {
+            // A probe failed while we were switching: trip again on its behalf
+            if (d_state.compare_exchange_weak(current,
+                                              Intercept | Pending,
+                                              std::memory_order_acq_rel,
+                                              std::memory_order_acquire))
+            {
+                d_endOfTrip.store((d_clock.now() + d_tripDuration).time_since_epoch().count(),
+                                  std::memory_order_release);
+                completeSwitch(TryLetThrough, Intercept);
+                return;
+            }
+        }
+        else if (stateOf(current) == TryLetThrough and recovers(current))
+        {
+            // Enough probes succeeded while we were switching
+            if (d_state.compare_exchange_weak(current,
+                                              LetThrough | Pending,
+                                              std::memory_order_acq_rel,
+                                              std::memory_order_acquire))
+            {
+                derived().resetClosed(d_clock.now());
+                completeClosing();
+                return;
+            }
+        }
+        else if (d_state.compare_exchange_weak(current,
+                                               current & ~word(Pending),
+                                               std::memory_order_acq_rel,
+                                               std::memory_order_acquire))
+        {
+            return;
+        }
+    }
+}
+
+} // namespace detail
+} // namespace resilient
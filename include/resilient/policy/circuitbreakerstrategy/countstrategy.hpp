@@ -1,12 +1,17 @@
 #pragma once
 
 #include <chrono>
+#include <cstdint>
+#include <limits>
 #include <memory>
 #include <mutex>
+#include <stdexcept>
 
 #include <resilient/common/variant.hpp>
 #include <resilient/detail/variant_utils.hpp>
 #include <resilient/policy/circuitbreaker.hpp>
+#include <resilient/policy/circuitbreakerstrategy/heldprobes.hpp>
+#include <resilient/policy/circuitbreakerstrategy/statechange.hpp>
 
 namespace resilient {
 
@@ -17,7 +22,7 @@ namespace resilient {
  * @tparam Clock The kind of clock to use when measuring time.
  */
 template<typename Clock = std::chrono::steady_clock>
-class CountStrategy : ICircuitbreakerStrategy
+class CountStrategy final : public ICircuitbreakerStrategy
 {
 public:
     /**
@@ -35,6 +40,32 @@ public:
                   std::chrono::microseconds failureInterval,
                   std::chrono::microseconds tripDuration,
                   unsigned long recoverSuccesses,
+                  Clock clock = Clock())
+    : CountStrategy(failures,
+                    failureInterval,
+                    tripDuration,
+                    recoverSuccesses,
+                    std::numeric_limits<unsigned long>::max(),
+                    std::move(clock))
+    {
+    }
+
+    /**
+     * @brief Construct a new Count Strategy object which limits the calls while it tries to
+     *        recover.
+     *
+     * @param maxProbes How many calls can run at the same time while the circuit breaker
+     *                  tries to recover. The other calls are intercepted. At least 1.
+     *                  Only the calls allowed while it tries to recover count towards it.
+     *
+     * See the other constructor for the other parameters.
+     * @throw std::invalid_argument If `maxProbes` is 0.
+     */
+    CountStrategy(unsigned long failures,
+                  std::chrono::microseconds failureInterval,
+                  std::chrono::microseconds tripDuration,
+                  unsigned long recoverSuccesses,
+                  unsigned long maxProbes,
                   Clock clock = Clock());
 
     bool allowCall() override
@@ -45,14 +76,26 @@ public:
 
     void registerFailure() override
     {
+        const std::uint64_t heldPeriod = releaseHeldProbe();
         std::lock_guard<std::mutex> guard{d_stateMutex};
-        reentrantRegisterFailure();
+        reentrantRegisterFailure(heldPeriod);
     }
 
     void registerSuccess() override
     {
+        const std::uint64_t heldPeriod = releaseHeldProbe();
         std::lock_guard<std::mutex> guard{d_stateMutex};
-        reentrantRegisterSuccess();
+        reentrantRegisterSuccess(heldPeriod);
+    }
+
+    /**
+     * @brief Push the state changes of the strategy to the queue.
+     *
+     * Must be called before the strategy is used by multiple threads.
+     */
+    void notifyStateChangesTo(std::shared_ptr<StateChangeQueue> queue)
+    {
+        d_stateChanges = std::move(queue);
     }
 
 private:
@@ -60,9 +103,17 @@ private:
 
     // Reentrant version of the public methods.
     // These can be called by the states hold in the variant
+    // The registrations take the half-open period of the slot the call took, or 0.
     bool reentrantAllowCall();
-    void reentrantRegisterFailure();
-    void reentrantRegisterSuccess();
+    void reentrantRegisterFailure(std::uint64_t heldPeriod);
+    void reentrantRegisterSuccess(std::uint64_t heldPeriod);
+
+    bool limitsProbes() const { return d_maxProbes != std::numeric_limits<unsigned long>::max(); }
+
+    std::uint64_t releaseHeldProbe() const
+    {
+        return limitsProbes() ? detail::HeldProbes::release(this) : 0;
+    }
 
     // Equivalent to Closed state.
     // State changes:
@@ -75,8 +126,8 @@ private:
         }
 
         bool allowCall() { return true; }
-        void registerSuccess() {}
-        void registerFailure();
+        void registerSuccess(std::uint64_t) {}
+        void registerFailure(std::uint64_t);
 
     private:
         void resetIfIntervalExpired(time_point now);
@@ -103,8 +154,8 @@ private:
         // But they might be called in a multi-threaded environment, as 1
         // thread might switch the strategy to Intercept while the other
         // passed already the check while it was in LetThrough.
-        void registerFailure() {}
-        void registerSuccess() {}
+        void registerFailure(std::uint64_t) {}
+        void registerSuccess(std::uint64_t) {}
 
     private:
         CountStrategy* d_parent;
@@ -112,21 +163,44 @@ private:
     };
 
     //Equivalent to Half-Open state.
+    // At most maxProbes calls can be running at the same time, the others are intercepted.
+    // When the probes are limited only the calls which took a slot in this state are probes:
+    // the others were allowed before the trip, and are ignored.
+    // If all the slots stay taken for tripDuration without any probe starting or ending, the
+    // probes were lost (registered on another thread, or never): a new period reclaims them.
     // State changes:
     // - when the next task execution succeeds -> switch to LetThrough
     // - when the next task execution fails -> switch to Intercept
     struct TryLetThrough
     {
 
-        TryLetThrough(CountStrategy* parent) : d_parent(parent), d_successfulRequests(0) {}
+        TryLetThrough(CountStrategy* parent, time_point now)
+        : d_parent(parent)
+        , d_period(detail::HeldProbes::newPeriod())
+        , d_lastProbeActivity(now)
+        , d_successfulRequests(0)
+        , d_runningProbes(0)
+        {
+        }
 
-        bool allowCall() { return true; }
-        void registerFailure();
-        void registerSuccess();
+        bool allowCall();
+        void registerFailure(std::uint64_t heldPeriod);
+        void registerSuccess(std::uint64_t heldPeriod);
 
     private:
+        bool isProbe(std::uint64_t heldPeriod) const
+        {
+            return not d_parent->limitsProbes() or heldPeriod == d_period;
+        }
+
         CountStrategy* d_parent;
+        std::uint64_t d_period;
+        // When a slot was last taken or released
+        time_point d_lastProbeActivity;
         unsigned long d_successfulRequests;
+        // The calls allowed which did not register yet.
+        // Protected by the state mutex, as the rest of the state.
+        unsigned long d_runningProbes;
     };
 
     // Switch the current state
@@ -137,18 +211,34 @@ private:
     template<typename T>
     void switchTo(T obj)
     {
+        const CircuitbreakerState from = visit(
+            detail::overload<CircuitbreakerState>([](const auto& state) { return stateOf(state); }),
+            d_state);
         d_state = std::move(obj);
+        // The state mutex makes this thread the only producer of the queue
+        if (d_stateChanges) {
+            d_stateChanges->push({this, from, stateOf(obj)});
+        }
+    }
+
+    static CircuitbreakerState stateOf(const LetThrough&) { return CircuitbreakerState::Closed; }
+    static CircuitbreakerState stateOf(const Intercept&) { return CircuitbreakerState::Open; }
+    static CircuitbreakerState stateOf(const TryLetThrough&)
+    {
+        return CircuitbreakerState::HalfOpen;
     }
 
     unsigned long d_failuresPerInterval;
     std::chrono::microseconds d_failureInterval;
     std::chrono::microseconds d_tripDuration;
     unsigned long d_successesBeforeRecovering;
+    unsigned long d_maxProbes;
     Clock d_clock;
 
     // Lock around changes to the variant
     std::mutex d_stateMutex;
     Variant<LetThrough, Intercept, TryLetThrough> d_state;
+    std::shared_ptr<StateChangeQueue> d_stateChanges;
 };
 
 template<typename Clock>
@@ -156,14 +246,19 @@ CountStrategy<Clock>::CountStrategy(unsigned long failures,
                                     std::chrono::microseconds failureInterval,
                                     std::chrono::microseconds tripDuration,
                                     unsigned long recoverSuccesses,
+                                    unsigned long maxProbes,
                                     Clock clock)
 : d_failuresPerInterval(failures)
 , d_failureInterval(failureInterval)
 , d_tripDuration(tripDuration)
 , d_successesBeforeRecovering(recoverSuccesses)
+, d_maxProbes(maxProbes)
 , d_clock(std::move(clock))
 , d_state(LetThrough(this, d_clock.now()))
 {
+    if (maxProbes == 0) {
+        throw std::invalid_argument("At least one probe must be allowed to recover");
+    }
 }
 
 template<typename Clock>
@@ -173,15 +268,17 @@ bool CountStrategy<Clock>::reentrantAllowCall()
 }
 
 template<typename Clock>
-void CountStrategy<Clock>::reentrantRegisterFailure()
+void CountStrategy<Clock>::reentrantRegisterFailure(std::uint64_t heldPeriod)
 {
-    visit(detail::overload<void>([](auto& obj) { obj.registerFailure(); }), d_state);
+    visit(detail::overload<void>([heldPeriod](auto& obj) { obj.registerFailure(heldPeriod); }),
+          d_state);
 }
 
 template<typename Clock>
-void CountStrategy<Clock>::reentrantRegisterSuccess()
+void CountStrategy<Clock>::reentrantRegisterSuccess(std::uint64_t heldPeriod)
 {
-    visit(detail::overload<void>([](auto& obj) { obj.registerSuccess(); }), d_state);
+    visit(detail::overload<void>([heldPeriod](auto& obj) { obj.registerSuccess(heldPeriod); }),
+          d_state);
 }
 
 template<typename Clock>
@@ -195,7 +292,7 @@ void CountStrategy<Clock>::LetThrough::resetIfIntervalExpired(time_point now)
 }
 
 template<typename Clock>
-void CountStrategy<Clock>::LetThrough::registerFailure()
+void CountStrategy<Clock>::LetThrough::registerFailure(std::uint64_t)
 {
     auto now = d_parent->d_clock.now();
 
@@ -211,23 +308,55 @@ void CountStrategy<Clock>::LetThrough::registerFailure()
 template<typename Clock>
 bool CountStrategy<Clock>::Intercept::allowCall()
 {
-    if (d_parent->d_clock.now() >= d_endTime) {
+    const time_point now = d_parent->d_clock.now();
+    if (now >= d_endTime) {
         CountStrategy<Clock>* parent = d_parent;
-        d_parent->switchTo(TryLetThrough(d_parent));
+        d_parent->switchTo(TryLetThrough(d_parent, now));
         return parent->reentrantAllowCall();
     }
     return false;
 }
 
 template<typename Clock>
-void CountStrategy<Clock>::TryLetThrough::registerFailure()
+bool CountStrategy<Clock>::TryLetThrough::allowCall()
 {
-    d_parent->switchTo(Intercept(d_parent, d_parent->d_clock.now()));
+    if (not d_parent->limitsProbes()) {
+        return true;
+    }
+    const time_point now = d_parent->d_clock.now();
+    if (d_runningProbes >= d_parent->d_maxProbes) {
+        if (now < d_lastProbeActivity + d_parent->d_tripDuration) {
+            return false;
+        }
+        // The probes were lost: start a new period, where this call is the first probe
+        d_period = detail::HeldProbes::newPeriod();
+        d_successfulRequests = 0;
+        d_runningProbes = 0;
+    }
+    d_lastProbeActivity = now;
+    d_runningProbes++;
+    detail::HeldProbes::take(d_parent, d_period);
+    return true;
+}
+
+template<typename Clock>
+void CountStrategy<Clock>::TryLetThrough::registerFailure(std::uint64_t heldPeriod)
+{
+    if (isProbe(heldPeriod)) {
+        d_parent->switchTo(Intercept(d_parent, d_parent->d_clock.now()));
+    }
 }
 
 template<typename Clock>
-void CountStrategy<Clock>::TryLetThrough::registerSuccess()
+void CountStrategy<Clock>::TryLetThrough::registerSuccess(std::uint64_t heldPeriod)
 {
+    if (not isProbe(heldPeriod)) {
+        return;
+    }
+    if (d_parent->limitsProbes()) {
+        d_runningProbes--;
+        d_lastProbeActivity = d_parent->d_clock.now();
+    }
     d_successfulRequests++;
     if (d_successfulRequests >= d_parent->d_successesBeforeRecovering) {
         d_parent->switchTo(LetThrough(d_parent, d_parent->d_clock.now()));
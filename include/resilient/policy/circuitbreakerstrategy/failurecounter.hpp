@@ -0,0 +1,155 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace resilient {
+
+namespace detail {
+
+// Size of a cache line on the architectures we care about.
+constexpr std::size_t cacheLineSize = 64;
+
+// Return an index which is stable for the current thread.
+// Indexes are assigned round robin, so threads are spread evenly across shards.
+inline std::size_t currentThreadIndex()
+{
+    static std::atomic<std::size_t> s_nextIndex{0};
+    thread_local std::size_t t_index = s_nextIndex.fetch_add(1, std::memory_order_relaxed);
+    return t_index;
+}
+
+} // namespace detail
+
+/**
+ * @brief Count failures in a single atomic shared by all the threads.
+ * @related resilient::LockFreeCountStrategy
+ *
+ * @par `FailureCounter` concept
+ * - `bool increment(unsigned long threshold)` counts a failure and returns true if the failures
+ *   counted since the last reset might have reached `threshold`.
+ * - `bool reached(unsigned long threshold)` returns true if the failures counted since the last
+ *   reset reached `threshold`.
+ * - `void reset()` starts counting from zero.
+ */
+class SharedFailureCounter
+{
+public:
+    SharedFailureCounter() : d_count(0) {}
+
+    bool increment(unsigned long threshold)
+    {
+        return d_count.fetch_add(1, std::memory_order_acq_rel) + 1 >= threshold;
+    }
+
+    bool reached(unsigned long threshold) const
+    {
+        return d_count.load(std::memory_order_acquire) >= threshold;
+    }
+
+    void reset() { d_count.store(0, std::memory_order_release); }
+
+private:
+    std::atomic<unsigned long> d_count;
+};
+
+/**
+ * @brief Count failures in per-thread slots, each on its own cache line.
+ * @related resilient::LockFreeCountStrategy
+ *
+ * Counting a failure only writes the slot of the current thread. The slots are summed only once
+ * one of them holds its share of the threshold, as before that the total can't have reached it.
+ *
+ * Threads are assigned round robin to the slots, so with more threads than `Shards` a slot is
+ * shared by several threads.
+ *
+ * @note
+ * Implements the `FailureCounter` concept.
+ *
+ * @tparam Shards The number of slots.
+ */
+template<std::size_t Shards = 16>
+class ShardedFailureCounter
+{
+public:
+    static_assert(Shards > 0, "At least one shard is required.");
+
+    ShardedFailureCounter() : d_generation(0), d_armedGeneration(s_disarmed)
+    {
+        for (Slot& slot : d_slots) {
+            slot.d_value.store(0);
+        }
+    }
+
+    bool increment(unsigned long threshold);
+    bool reached(unsigned long threshold) const;
+    void reset() { d_generation.fetch_add(1); }
+
+private:
+    // Each slot holds the generation it counts for in the high 32 bits and the count in the low
+    // 32 bits. Resetting only bumps the generation: slots from an old one count as zero.
+    using word = std::uint64_t;
+
+    static constexpr word generationOf(word value) { return value >> 32; }
+    static constexpr word countOf(word value) { return value & 0xffffffff; }
+
+    enum : word
+    {
+        s_disarmed = ~word(0)
+    };
+
+    struct Slot
+    {
+        std::atomic<word> d_value;
+        char d_padding[detail::cacheLineSize - sizeof(std::atomic<word>)];
+    };
+
+    std::atomic<word> d_generation;
+    // The generation in which a slot reached its share of the threshold.
+    // From then on every failure sums the slots.
+    // NOTE: This and the slots use sequentially consistent operations. This guarantees that
+    //       when two threads race, either the one arming sees the other's failure when summing,
+    //       or the other sees the counter armed.
+    std::atomic<word> d_armedGeneration;
+    std::array<Slot, Shards> d_slots;
+};
+
+template<std::size_t Shards>
+bool ShardedFailureCounter<Shards>::increment(unsigned long threshold)
+{
+    const word generation = d_generation.load() & 0xffffffff;
+    Slot& slot = d_slots[detail::currentThreadIndex() % Shards];
+
+    word current = slot.d_value.load(std::memory_order_relaxed);
+    word count;
+    do {
+        count = generationOf(current) == generation ? countOf(current) + 1 : 1;
+    } while (not slot.d_value.compare_exchange_weak(current, (generation << 32) | count));
+
+    if (count * Shards >= threshold) {
+        d_armedGeneration.store(generation);
+    }
+    else if (d_armedGeneration.load() != generation)
+    {
+        return false;
+    }
+    return reached(threshold);
+}
+
+template<std::size_t Shards>
+bool ShardedFailureCounter<Shards>::reached(unsigned long threshold) const
+{
+    const word generation = d_generation.load() & 0xffffffff;
+    unsigned long total = 0;
+    for (const Slot& slot : d_slots) {
+        word value = slot.d_value.load();
+        if (generationOf(value) == generation) {
+            total += countOf(value);
+        }
+    }
+    return total >= threshold;
+}
+
+} // namespace resilient
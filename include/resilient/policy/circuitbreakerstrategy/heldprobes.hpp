@@ -0,0 +1,85 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <iterator>
+#include <vector>
+
+namespace resilient {
+namespace detail {
+
+/**
+ * The probe slots taken by the calls running on the current thread.
+ *
+ * `ICircuitbreakerStrategy` doesn't pass anything from `allowCall()` to the registration of the
+ * call, but `Circuitbreaker` calls both from the thread running the call. A strategy limiting
+ * the probes records here the slot a call takes, with the id of the half-open period it belongs
+ * to, so that when the call is registered it can tell whether it took a slot of the current
+ * period. Calls allowed before the trip, or in a previous half-open period, must neither
+ * release a slot they never took nor count as probes.
+ */
+class HeldProbes
+{
+public:
+    /**
+     * A new id for a half-open period, unique in the process. Never 0.
+     */
+    static std::uint64_t newPeriod()
+    {
+        static std::atomic<std::uint64_t> nextPeriod{1};
+        return nextPeriod.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    /**
+     * Record that the current thread took a slot of `strategy` in the half-open `period`.
+     */
+    static void take(const void* strategy, std::uint64_t period)
+    {
+        std::vector<Entry>& entries = local();
+        // Slots of earlier periods were dropped with their period: forget them, in case their
+        // calls were never registered
+        entries.erase(std::remove_if(entries.begin(),
+                                     entries.end(),
+                                     [strategy, period](const Entry& entry) {
+                                         return entry.d_strategy == strategy
+                                                and entry.d_period != period;
+                                     }),
+                      entries.end());
+        entries.push_back({strategy, period});
+    }
+
+    /**
+     * Forget the last slot of `strategy` the current thread took.
+     *
+     * @return The period of the slot, or 0 if the thread holds no slot of the strategy.
+     */
+    static std::uint64_t release(const void* strategy)
+    {
+        std::vector<Entry>& entries = local();
+        for (auto entry = entries.rbegin(); entry != entries.rend(); ++entry) {
+            if (entry->d_strategy == strategy) {
+                const std::uint64_t period = entry->d_period;
+                entries.erase(std::next(entry).base());
+                return period;
+            }
+        }
+        return 0;
+    }
+
+private:
+    struct Entry
+    {
+        const void* d_strategy;
+        std::uint64_t d_period;
+    };
+
+    static std::vector<Entry>& local()
+    {
+        thread_local std::vector<Entry> entries;
+        return entries;
+    }
+};
+
+} // namespace detail
+} // namespace resilient
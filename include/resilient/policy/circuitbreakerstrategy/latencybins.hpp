@@ -0,0 +1,59 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+namespace resilient {
+namespace detail {
+
+/**
+ * Map durations to the bins of a fixed size log-linear histogram.
+ *
+ * Each power of two of microseconds is split in `subBins` bins of equal width, so the width of a
+ * bin is at most 25% of its lower bound. Durations longer than the last bin fall in it.
+ */
+struct LatencyBins
+{
+    // log2 of the number of bins for each power of two
+    static constexpr unsigned subBinBits = 2;
+    static constexpr std::uint64_t subBins = std::uint64_t(1) << subBinBits;
+    // Enough to cover up to about 9 minutes
+    static constexpr std::size_t count = 28 * subBins;
+
+    static std::size_t binOf(std::chrono::nanoseconds duration)
+    {
+        const std::int64_t micros =
+            std::chrono::duration_cast<std::chrono::microseconds>(duration).count();
+        const std::uint64_t value = micros > 0 ? static_cast<std::uint64_t>(micros) : 0;
+        if (value < subBins) {
+            return value;
+        }
+        unsigned msb = 0;
+        while ((value >> (msb + 1)) != 0) {
+            msb++;
+        }
+        const unsigned exponent = msb - subBinBits + 1;
+        const std::size_t bin = exponent * subBins + ((value >> (exponent - 1)) - subBins);
+        return bin < count ? bin : count - 1;
+    }
+
+    // The smallest duration which falls in the bin after `bin`.
+    static std::chrono::microseconds upperBound(std::size_t bin)
+    {
+        return lowerBound(bin + 1);
+    }
+
+    static std::chrono::microseconds lowerBound(std::size_t bin)
+    {
+        const std::uint64_t exponent = bin >> subBinBits;
+        const std::uint64_t mantissa = bin & (subBins - 1);
+        if (exponent == 0) {
+            return std::chrono::microseconds(mantissa);
+        }
+        return std::chrono::microseconds((subBins + mantissa) << (exponent - 1));
+    }
+};
+
+} // namespace detail
+} // namespace resilient
@@ -0,0 +1,142 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <limits>
+
+#include <resilient/policy/circuitbreakerstrategy/atomicstatestrategy.hpp>
+#include <resilient/policy/circuitbreakerstrategy/failurecounter.hpp>
+
+namespace resilient {
+
+/**
+ * @brief Open the circuit breaker if a number of failures happen over a time intervall,
+ *        without taking any lock.
+ * @related resilient::ICircuitbreakerStrategy
+ *
+ * Behaves like `CountStrategy`, but the state of the circuit breaker is packed in a single
+ * atomic word and the time points the states depend on are kept in separate atomics.
+ * Calls never block each other while the circuit breaker is closed: a successful call only
+ * reads the state word.
+ *
+ * The failures are counted by the `FailureCounter`. Use `ShardedFailureCounter` when many
+ * threads fail at the same time, so that they don't all write the same cache line.
+ *
+ * @tparam Clock The kind of clock to use when measuring time.
+ * @tparam FailureCounter The counter of the failures while the circuit breaker is closed.
+ *                        Must implement the `FailureCounter` concept.
+ */
+template<typename Clock = std::chrono::steady_clock,
+         typename FailureCounter = SharedFailureCounter>
+class LockFreeCountStrategy final
+: public detail::AtomicStateStrategy<LockFreeCountStrategy<Clock, FailureCounter>, Clock>
+{
+public:
+    /**
+     * @brief Construct a new LockFreeCountStrategy object.
+     *
+     * @param failures Number of failures over the interval which will trigger the circuit breaker.
+     * @param failureInterval The duration of the interval over which to count the failures.
+     * @param tripDuration How long to keep the circuit breaker open once it trips.
+     * @param recoverSuccesses How many task executions should succeed before resetting the
+     *                         circuit breaker to it's normal state after it triggered.
+     * @param clock An instance of the clock to use to measure time. Defaults to a default initialized one.
+     */
+    LockFreeCountStrategy(unsigned long failures,
+                          std::chrono::microseconds failureInterval,
+                          std::chrono::microseconds tripDuration,
+                          unsigned long recoverSuccesses,
+                          Clock clock = Clock())
+    : LockFreeCountStrategy(failures,
+                            failureInterval,
+                            tripDuration,
+                            recoverSuccesses,
+                            std::numeric_limits<unsigned long>::max(),
+                            std::move(clock))
+    {
+    }
+
+    /**
+     * @brief Construct a new LockFreeCountStrategy object which limits the calls while it tries to recover.
+     *
+     * @param maxProbes How many calls can run at the same time while the circuit breaker
+     *                  tries to recover. The other calls are intercepted. At least 1.
+     *                  Only the calls allowed while it tries to recover count towards it.
+     *
+     * See the other constructor for the other parameters.
+     * @throw std::invalid_argument If `maxProbes` is 0.
+     */
+    LockFreeCountStrategy(unsigned long failures,
+                          std::chrono::microseconds failureInterval,
+                          std::chrono::microseconds tripDuration,
+                          unsigned long recoverSuccesses,
+                          unsigned long maxProbes,
+                          Clock clock = Clock());
+
+private:
+    using base = detail::AtomicStateStrategy<LockFreeCountStrategy<Clock, FailureCounter>, Clock>;
+    using time_point = typename Clock::time_point;
+    using rep = typename time_point::duration::rep;
+
+    friend base;
+
+    void closedFailure(time_point now);
+    void closedSuccess() {}
+    void resetClosed(time_point now);
+    bool shouldTrip() const { return d_failures.reached(d_failuresPerInterval); }
+
+    // Start a new interval if the current one expired.
+    void restartIntervalIfExpired(time_point now);
+
+    unsigned long d_failuresPerInterval;
+    std::chrono::microseconds d_failureInterval;
+    FailureCounter d_failures;
+    std::atomic<rep> d_intervalStart;
+};
+
+template<typename Clock, typename FailureCounter>
+LockFreeCountStrategy<Clock, FailureCounter>::LockFreeCountStrategy(
+    unsigned long failures,
+    std::chrono::microseconds failureInterval,
+    std::chrono::microseconds tripDuration,
+    unsigned long recoverSuccesses,
+    unsigned long maxProbes,
+    Clock clock)
+: base(tripDuration, recoverSuccesses, maxProbes, std::move(clock))
+, d_failuresPerInterval(failures)
+, d_failureInterval(failureInterval)
+, d_failures()
+, d_intervalStart(this->d_clock.now().time_since_epoch().count())
+{
+}
+
+template<typename Clock, typename FailureCounter>
+void LockFreeCountStrategy<Clock, FailureCounter>::closedFailure(time_point now)
+{
+    restartIntervalIfExpired(now);
+    if (d_failures.increment(d_failuresPerInterval)) {
+        this->tripIfClosed(now);
+    }
+}
+
+template<typename Clock, typename FailureCounter>
+void LockFreeCountStrategy<Clock, FailureCounter>::resetClosed(time_point now)
+{
+    d_failures.reset();
+    d_intervalStart.store(now.time_since_epoch().count(), std::memory_order_release);
+}
+
+template<typename Clock, typename FailureCounter>
+void LockFreeCountStrategy<Clock, FailureCounter>::restartIntervalIfExpired(time_point now)
+{
+    rep intervalStart = d_intervalStart.load(std::memory_order_acquire);
+    if (now > time_point(typename time_point::duration(intervalStart)) + d_failureInterval) {
+        // Only one thread restarts the interval, the others count in the new one.
+        if (d_intervalStart.compare_exchange_strong(
+                intervalStart, now.time_since_epoch().count(), std::memory_order_acq_rel)) {
+            d_failures.reset();
+        }
+    }
+}
+
+} // namespace resilient
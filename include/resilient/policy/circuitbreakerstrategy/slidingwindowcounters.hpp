@@ -0,0 +1,145 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+
+namespace resilient {
+namespace detail {
+
+/**
+ * The duration of each of the `buckets` buckets dividing `window`.
+ *
+ * @throw std::invalid_argument If there are no buckets, or if a bucket would be shorter than
+ *        a unit of `Duration`.
+ */
+template<typename Duration>
+Duration bucketDuration(std::chrono::microseconds window, std::size_t buckets)
+{
+    if (buckets == 0) {
+        throw std::invalid_argument("The window must have at least one bucket");
+    }
+    const Duration duration = std::chrono::duration_cast<Duration>(window)
+                              / static_cast<typename Duration::rep>(buckets);
+    if (duration <= Duration::zero()) {
+        throw std::invalid_argument("The window is too short for the number of buckets");
+    }
+    return duration;
+}
+
+/**
+ * Counters over a sliding window of time divided in a fixed number of buckets.
+ *
+ * Each counter of each bucket is a single atomic word which holds the index of the bucket it
+ * counts for in the high 32 bits and the count in the low 32 bits. A bucket is reused once the
+ * window moved past it: the first add for the new index restarts the count, so no thread ever
+ * needs to clear the buckets and adding never loses a count.
+ *
+ * All the memory is allocated at construction.
+ *
+ * @tparam Counters The number of counters in each bucket.
+ */
+template<std::size_t Counters>
+class SlidingWindowCounters
+{
+public:
+    using counts = std::array<unsigned long, Counters>;
+
+    explicit SlidingWindowCounters(std::size_t buckets)
+    : d_buckets(buckets), d_words(new std::atomic<word>[buckets * Counters])
+    {
+        reset();
+    }
+
+    /**
+     * Increment `counter` in the bucket with the given index.
+     * Indexes of buckets already out of the window are ignored.
+     */
+    void add(std::uint64_t bucketIndex, std::size_t counter);
+
+    /**
+     * Sum each counter over the window ending with the bucket with the given index.
+     */
+    counts sum(std::uint64_t bucketIndex) const;
+
+    /**
+     * Set all the counters to zero.
+     */
+    void reset();
+
+private:
+    using word = std::uint64_t;
+
+    static word indexOf(word value) { return value >> 32; }
+    static word countOf(word value) { return value & 0xffffffff; }
+    static word truncate(std::uint64_t bucketIndex) { return bucketIndex & 0xffffffff; }
+
+    // How many buckets `older` is behind `newer`, in modulo 2^32 arithmetic.
+    static word distance(word newer, word older) { return (newer - older) & 0xffffffff; }
+
+    std::atomic<word>& at(std::uint64_t bucketIndex, std::size_t counter) const
+    {
+        return d_words[(bucketIndex % d_buckets) * Counters + counter];
+    }
+
+    std::size_t d_buckets;
+    std::unique_ptr<std::atomic<word>[]> d_words;
+};
+
+template<std::size_t Counters>
+void SlidingWindowCounters<Counters>::add(std::uint64_t bucketIndex, std::size_t counter)
+{
+    const word index = truncate(bucketIndex);
+    std::atomic<word>& slot = at(bucketIndex, counter);
+
+    word current = slot.load(std::memory_order_relaxed);
+    word next;
+    do {
+        if (countOf(current) != 0 and indexOf(current) == index) {
+            next = current + 1;
+        }
+        else if (countOf(current) == 0 or distance(index, indexOf(current)) < (word(1) << 31))
+        {
+            // The slot is empty or holds a bucket which already left the window
+            next = (index << 32) | 1;
+        }
+        else
+        {
+            // Another thread already moved the slot to a newer bucket: ours left the window
+            return;
+        }
+    } while (not slot.compare_exchange_weak(
+        current, next, std::memory_order_acq_rel, std::memory_order_relaxed));
+}
+
+template<std::size_t Counters>
+typename SlidingWindowCounters<Counters>::counts
+SlidingWindowCounters<Counters>::sum(std::uint64_t bucketIndex) const
+{
+    const word index = truncate(bucketIndex);
+    counts result{};
+    for (std::size_t bucket = 0; bucket < d_buckets; bucket++) {
+        for (std::size_t counter = 0; counter < Counters; counter++) {
+            word value = d_words[bucket * Counters + counter].load(std::memory_order_acquire);
+            if (distance(index, indexOf(value)) < d_buckets) {
+                result[counter] += countOf(value);
+            }
+        }
+    }
+    return result;
+}
+
+template<std::size_t Counters>
+void SlidingWindowCounters<Counters>::reset()
+{
+    for (std::size_t i = 0; i < d_buckets * Counters; i++) {
+        d_words[i].store(0, std::memory_order_release);
+    }
+}
+
+} // namespace detail
+} // namespace resilient
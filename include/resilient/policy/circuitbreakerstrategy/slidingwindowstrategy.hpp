@@ -0,0 +1,156 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+#include <resilient/policy/circuitbreakerstrategy/atomicstatestrategy.hpp>
+#include <resilient/policy/circuitbreakerstrategy/slidingwindowcounters.hpp>
+
+namespace resilient {
+
+/**
+ * @brief Open the circuit breaker when the rate of failures over a sliding window of time is
+ *        too high.
+ * @related resilient::ICircuitbreakerStrategy
+ *
+ * The window is divided in a fixed number of buckets which count the successes and failures of
+ * the calls. As time passes the oldest bucket is dropped from the window, so failures are not
+ * forgotten all at once as it happens with a tumbling interval.
+ *
+ * The circuit breaker trips when at least `minimumCalls` calls happened in the window and the
+ * ratio of failures over the calls reaches `failureRate`.
+ *
+ * Registering a call increments a single atomic counter; failures also sum the buckets to check
+ * the rate, which costs the same whatever the number of calls. No memory is allocated after
+ * construction.
+ *
+ * @tparam Clock The kind of clock to use when measuring time.
+ */
+template<typename Clock = std::chrono::steady_clock>
+class SlidingWindowStrategy final
+: public detail::AtomicStateStrategy<SlidingWindowStrategy<Clock>, Clock>
+{
+public:
+    /**
+     * @brief Construct a new SlidingWindowStrategy object.
+     *
+     * @param failureRate The ratio of failures over the calls in the window, between 0 and 1,
+     *                    at which the circuit breaker trips.
+     * @param minimumCalls The minimum number of calls in the window before it can trip.
+     * @param window The duration of the sliding window.
+     * @param buckets In how many buckets to divide the window. More buckets make the window
+     *                slide more smoothly, but make checking the rate slower. At least 1, and
+     *                at most the ticks of the clock in the window.
+     * @param tripDuration How long to keep the circuit breaker open once it trips.
+     * @param recoverSuccesses How many task executions should succeed before resetting the
+     *                         circuit breaker to it's normal state after it triggered.
+     * @param clock An instance of the clock to use to measure time. Defaults to a default initialized one.
+     * @throw std::invalid_argument If the window can't be divided in `buckets` buckets.
+     */
+    SlidingWindowStrategy(double failureRate,
+                          unsigned long minimumCalls,
+                          std::chrono::microseconds window,
+                          std::size_t buckets,
+                          std::chrono::microseconds tripDuration,
+                          unsigned long recoverSuccesses,
+                          Clock clock = Clock())
+    : SlidingWindowStrategy(failureRate,
+                            minimumCalls,
+                            window,
+                            buckets,
+                            tripDuration,
+                            recoverSuccesses,
+                            std::numeric_limits<unsigned long>::max(),
+                            std::move(clock))
+    {
+    }
+
+    /**
+     * @brief Construct a new SlidingWindowStrategy object which limits the calls while it tries to recover.
+     *
+     * @param maxProbes How many calls can run at the same time while the circuit breaker
+     *                  tries to recover. The other calls are intercepted. At least 1.
+     *                  Only the calls allowed while it tries to recover count towards it.
+     *
+     * See the other constructor for the other parameters.
+     * @throw std::invalid_argument If `maxProbes` is 0.
+     */
+    SlidingWindowStrategy(double failureRate,
+                          unsigned long minimumCalls,
+                          std::chrono::microseconds window,
+                          std::size_t buckets,
+                          std::chrono::microseconds tripDuration,
+                          unsigned long recoverSuccesses,
+                          unsigned long maxProbes,
+                          Clock clock = Clock());
+
+private:
+    using base = detail::AtomicStateStrategy<SlidingWindowStrategy<Clock>, Clock>;
+    using time_point = typename Clock::time_point;
+
+    friend base;
+
+    enum Counter : std::size_t
+    {
+        Successes = 0,
+        Failures = 1
+    };
+
+    void closedFailure(time_point now);
+    void closedSuccess() { d_counters.add(bucketIndex(this->d_clock.now()), Successes); }
+    void resetClosed(time_point) { d_counters.reset(); }
+    bool shouldTrip() { return shouldTrip(bucketIndex(this->d_clock.now())); }
+
+    bool shouldTrip(std::uint64_t bucketIndex) const;
+
+    std::uint64_t bucketIndex(time_point now) const
+    {
+        return static_cast<std::uint64_t>(now.time_since_epoch() / d_bucketDuration);
+    }
+
+    double d_failureRate;
+    unsigned long d_minimumCalls;
+    typename Clock::duration d_bucketDuration;
+    detail::SlidingWindowCounters<2> d_counters;
+};
+
+template<typename Clock>
+SlidingWindowStrategy<Clock>::SlidingWindowStrategy(double failureRate,
+                                                    unsigned long minimumCalls,
+                                                    std::chrono::microseconds window,
+                                                    std::size_t buckets,
+                                                    std::chrono::microseconds tripDuration,
+                                                    unsigned long recoverSuccesses,
+                                                    unsigned long maxProbes,
+                                                    Clock clock)
+: base(tripDuration, recoverSuccesses, maxProbes, std::move(clock))
+, d_failureRate(failureRate)
+, d_minimumCalls(minimumCalls)
+, d_bucketDuration(detail::bucketDuration<typename Clock::duration>(window, buckets))
+, d_counters(buckets)
+{
+}
+
+template<typename Clock>
+void SlidingWindowStrategy<Clock>::closedFailure(time_point now)
+{
+    const std::uint64_t index = bucketIndex(now);
+    d_counters.add(index, Failures);
+    // Only failures need to trip the circuit breaker, so we check the rate only here.
+    if (shouldTrip(index)) {
+        this->tripIfClosed(now);
+    }
+}
+
+template<typename Clock>
+bool SlidingWindowStrategy<Clock>::shouldTrip(std::uint64_t bucketIndex) const
+{
+    auto counts = d_counters.sum(bucketIndex);
+    const unsigned long calls = counts[Successes] + counts[Failures];
+    return calls >= d_minimumCalls and calls > 0
+           and static_cast<double>(counts[Failures]) >= d_failureRate * calls;
+}
+
+} // namespace resilient
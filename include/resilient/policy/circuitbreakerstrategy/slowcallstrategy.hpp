@@ -0,0 +1,250 @@
+#pragma once
+
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+#include <resilient/policy/circuitbreakerstrategy/atomicstatestrategy.hpp>
+#include <resilient/policy/circuitbreakerstrategy/latencybins.hpp>
+#include <resilient/policy/circuitbreakerstrategy/slidingwindowcounters.hpp>
+
+namespace resilient {
+
+/**
+ * @brief Open the circuit breaker when the calls over a sliding window of time are too slow.
+ * @related resilient::ICircuitbreakerStrategy
+ *
+ * A slow dependency can hurt more than a failing one, as the callers wait for it.
+ * This strategy uses the duration of each call, both successful and failed, and trips when
+ * either:
+ * - the ratio of calls which took at least `slowCallDuration` reaches `slowCallRate`, or
+ * - the `percentile` of the call durations reaches `percentileLimit`.
+ *
+ * The durations are recorded in a fixed size log-linear histogram for each bucket of the
+ * sliding window, so the memory used does not depend on the number of calls. The percentile is
+ * an upper bound with a precision of 25%.
+ * Registering a call increments one or two atomic counters; the window is summed only when the
+ * call was slow enough to possibly trip the circuit breaker.
+ *
+ * Calls registered without a duration are ignored.
+ *
+ * @tparam Clock The kind of clock to use when measuring time.
+ */
+template<typename Clock = std::chrono::steady_clock>
+class SlowCallStrategy final
+: public detail::AtomicStateStrategy<SlowCallStrategy<Clock>, Clock>
+{
+public:
+    /**
+     * @brief Construct a new SlowCallStrategy object.
+     *
+     * @param slowCallDuration How long a call must take to be considered slow.
+     * @param slowCallRate The ratio of slow calls over the calls in the window, between 0 and 1,
+     *                     at which the circuit breaker trips. Use a value above 1 to never trip
+     *                     because of it.
+     * @param percentile The percentile of the call durations to check, between 0 and 1.
+     *                   For example 0.99 for the p99.
+     * @param percentileLimit The duration at which the percentile trips the circuit breaker.
+     *                        Use `std::chrono::microseconds::max()` to never trip because of it.
+     * @param minimumCalls The minimum number of calls in the window before it can trip.
+     * @param window The duration of the sliding window.
+     * @param buckets In how many buckets to divide the window. At least 1, and at most the
+     *                ticks of the clock in the window.
+     * @param tripDuration How long to keep the circuit breaker open once it trips.
+     * @param recoverSuccesses How many task executions should succeed before resetting the
+     *                         circuit breaker to it's normal state after it triggered.
+     * @param clock An instance of the clock to use to measure time. Defaults to a default initialized one.
+     * @throw std::invalid_argument If the window can't be divided in `buckets` buckets.
+     */
+    SlowCallStrategy(std::chrono::microseconds slowCallDuration,
+                     double slowCallRate,
+                     double percentile,
+                     std::chrono::microseconds percentileLimit,
+                     unsigned long minimumCalls,
+                     std::chrono::microseconds window,
+                     std::size_t buckets,
+                     std::chrono::microseconds tripDuration,
+                     unsigned long recoverSuccesses,
+                     Clock clock = Clock())
+    : SlowCallStrategy(slowCallDuration,
+                       slowCallRate,
+                       percentile,
+                       percentileLimit,
+                       minimumCalls,
+                       window,
+                       buckets,
+                       tripDuration,
+                       recoverSuccesses,
+                       std::numeric_limits<unsigned long>::max(),
+                       std::move(clock))
+    {
+    }
+
+    /**
+     * @brief Construct a new SlowCallStrategy object which limits the calls while it tries to recover.
+     *
+     * @param maxProbes How many calls can run at the same time while the circuit breaker
+     *                  tries to recover. The other calls are intercepted. At least 1.
+     *                  Only the calls allowed while it tries to recover count towards it.
+     *
+     * See the other constructor for the other parameters.
+     * @throw std::invalid_argument If `maxProbes` is 0.
+     */
+    SlowCallStrategy(std::chrono::microseconds slowCallDuration,
+                     double slowCallRate,
+                     double percentile,
+                     std::chrono::microseconds percentileLimit,
+                     unsigned long minimumCalls,
+                     std::chrono::microseconds window,
+                     std::size_t buckets,
+                     std::chrono::microseconds tripDuration,
+                     unsigned long recoverSuccesses,
+                     unsigned long maxProbes,
+                     Clock clock = Clock());
+
+    bool needsCallDuration() const override { return true; }
+
+    void registerTimedFailure(std::chrono::nanoseconds duration) override
+    {
+        this->registerFailureWith(duration);
+    }
+
+    void registerTimedSuccess(std::chrono::nanoseconds duration) override
+    {
+        this->registerSuccessWith(duration);
+    }
+
+    /**
+     * @brief The upper bound of the given percentile of the durations of the calls in the window.
+     *
+     * @param percentile The percentile, between 0 and 1.
+     */
+    std::chrono::microseconds percentileDuration(double percentile)
+    {
+        return percentileDuration(percentile, d_counters.sum(bucketIndex(this->d_clock.now())));
+    }
+
+private:
+    using base = detail::AtomicStateStrategy<SlowCallStrategy<Clock>, Clock>;
+    using time_point = typename Clock::time_point;
+
+    // The first counter counts the slow calls, the others are the bins of the histogram
+    enum : std::size_t
+    {
+        SlowCalls = 0,
+        FirstBin = 1
+    };
+    using counters = detail::SlidingWindowCounters<FirstBin + detail::LatencyBins::count>;
+
+    friend base;
+
+    void closedFailure(time_point) {}
+    void closedFailure(time_point now, std::chrono::nanoseconds duration) { record(now, duration); }
+    void closedSuccess() {}
+    void closedSuccess(std::chrono::nanoseconds duration) { record(this->d_clock.now(), duration); }
+    void resetClosed(time_point) { d_counters.reset(); }
+    bool shouldTrip() { return shouldTrip(d_counters.sum(bucketIndex(this->d_clock.now()))); }
+
+    void record(time_point now, std::chrono::nanoseconds duration);
+    bool shouldTrip(const typename counters::counts& counts) const;
+    std::chrono::microseconds percentileDuration(double percentile,
+                                                 const typename counters::counts& counts) const;
+
+    std::uint64_t bucketIndex(time_point now) const
+    {
+        return static_cast<std::uint64_t>(now.time_since_epoch() / d_bucketDuration);
+    }
+
+    std::chrono::microseconds d_slowCallDuration;
+    double d_slowCallRate;
+    double d_percentile;
+    std::chrono::microseconds d_percentileLimit;
+    unsigned long d_minimumCalls;
+    typename Clock::duration d_bucketDuration;
+    counters d_counters;
+};
+
+template<typename Clock>
+SlowCallStrategy<Clock>::SlowCallStrategy(std::chrono::microseconds slowCallDuration,
+                                          double slowCallRate,
+                                          double percentile,
+                                          std::chrono::microseconds percentileLimit,
+                                          unsigned long minimumCalls,
+                                          std::chrono::microseconds window,
+                                          std::size_t buckets,
+                                          std::chrono::microseconds tripDuration,
+                                          unsigned long recoverSuccesses,
+                                          unsigned long maxProbes,
+                                          Clock clock)
+: base(tripDuration, recoverSuccesses, maxProbes, std::move(clock))
+, d_slowCallDuration(slowCallDuration)
+, d_slowCallRate(slowCallRate)
+, d_percentile(percentile)
+, d_percentileLimit(percentileLimit)
+, d_minimumCalls(minimumCalls)
+, d_bucketDuration(detail::bucketDuration<typename Clock::duration>(window, buckets))
+, d_counters(buckets)
+{
+}
+
+template<typename Clock>
+void SlowCallStrategy<Clock>::record(time_point now, std::chrono::nanoseconds duration)
+{
+    const std::uint64_t index = bucketIndex(now);
+    // Compare in microseconds, so that limits as big as microseconds::max() don't overflow
+    const auto micros = std::chrono::duration_cast<std::chrono::microseconds>(duration);
+    const bool slow = micros >= d_slowCallDuration;
+    if (slow) {
+        d_counters.add(index, SlowCalls);
+    }
+    const std::size_t bin = detail::LatencyBins::binOf(duration);
+    d_counters.add(index, FirstBin + bin);
+
+    // Only a call which is slow or in a bin reaching the limit can make the circuit breaker
+    // trip: the percentile is the upper bound of a bin, so compare the same quantity.
+    if (slow or detail::LatencyBins::upperBound(bin) >= d_percentileLimit) {
+        if (shouldTrip(d_counters.sum(index))) {
+            this->tripIfClosed(now);
+        }
+    }
+}
+
+template<typename Clock>
+bool SlowCallStrategy<Clock>::shouldTrip(const typename counters::counts& counts) const
+{
+    unsigned long calls = 0;
+    for (std::size_t bin = 0; bin < detail::LatencyBins::count; bin++) {
+        calls += counts[FirstBin + bin];
+    }
+    if (calls == 0 or calls < d_minimumCalls) {
+        return false;
+    }
+    return static_cast<double>(counts[SlowCalls]) >= d_slowCallRate * calls
+           or percentileDuration(d_percentile, counts) >= d_percentileLimit;
+}
+
+template<typename Clock>
+std::chrono::microseconds
+SlowCallStrategy<Clock>::percentileDuration(double percentile,
+                                            const typename counters::counts& counts) const
+{
+    unsigned long calls = 0;
+    for (std::size_t bin = 0; bin < detail::LatencyBins::count; bin++) {
+        calls += counts[FirstBin + bin];
+    }
+    // The number of calls which must be at or below the percentile
+    const double rank = std::ceil(percentile * calls);
+
+    unsigned long seen = 0;
+    for (std::size_t bin = 0; bin < detail::LatencyBins::count; bin++) {
+        seen += counts[FirstBin + bin];
+        if (seen > 0 and seen >= rank) {
+            return detail::LatencyBins::upperBound(bin);
+        }
+    }
+    return std::chrono::microseconds::zero();
+}
+
+} // namespace resilient
@@ -0,0 +1,292 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <resilient/detail/spscqueue.hpp>
+#include <resilient/policy/circuitbreaker.hpp>
+
+namespace resilient {
+
+/**
+ * @brief The states of a circuit breaker.
+ * @related resilient::ICircuitbreakerStrategy
+ */
+enum class CircuitbreakerState
+{
+    // Calls are allowed
+    Closed,
+    // Calls are intercepted
+    Open,
+    // Some calls are allowed to test whether the dependency recovered
+    HalfOpen
+};
+
+/**
+ * @brief A circuit breaker strategy changed state.
+ * @related resilient::StateChangeDispatcher
+ */
+struct CircuitbreakerStateChange
+{
+    // The strategy which changed state
+    const ICircuitbreakerStrategy* strategy;
+    CircuitbreakerState from;
+    CircuitbreakerState to;
+};
+
+namespace detail {
+
+// Wake up the thread of a `StateChangeDispatcher` when it sleeps and there is something to do.
+// Shared with the queues, which can outlive the dispatcher.
+class StateChangeWakeUp
+{
+public:
+    StateChangeWakeUp() : d_sleeping(false), d_woken(false) {}
+
+    // Called by a producer after pushing an event: lock only if the consumer sleeps.
+    void notifyIfSleeping()
+    {
+        // Pairs with the fence in `sleepUnless()`: either the consumer sees the event,
+        // or we see it sleeping.
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (d_sleeping.load(std::memory_order_relaxed)) {
+            notify();
+        }
+    }
+
+    void notify()
+    {
+        {
+            std::lock_guard<std::mutex> guard{d_mutex};
+            d_woken = true;
+        }
+        d_condition.notify_one();
+    }
+
+    // Called by the consumer: sleep until notified, unless `hasWork()` after announcing it.
+    template<typename Predicate>
+    void sleepUnless(Predicate hasWork)
+    {
+        std::unique_lock<std::mutex> lock{d_mutex};
+        d_sleeping.store(true, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (not d_woken and not hasWork()) {
+            d_condition.wait(lock, [this]() { return d_woken; });
+        }
+        d_woken = false;
+        d_sleeping.store(false, std::memory_order_relaxed);
+    }
+
+private:
+    std::mutex d_mutex;
+    std::condition_variable d_condition;
+    std::atomic<bool> d_sleeping;
+    bool d_woken;
+};
+
+} // namespace detail
+
+/**
+ * @brief The queue a strategy pushes its state changes to.
+ * @related resilient::StateChangeDispatcher
+ *
+ * A strategy is the only producer of its queue: its state changes are already serialized.
+ * Pushing never blocks: if the queue is full the event is dropped.
+ */
+class StateChangeQueue
+{
+public:
+    /**
+     * @brief Construct a queue holding at least `capacity` events, which is not dispatched.
+     */
+    explicit StateChangeQueue(std::size_t capacity) : d_changes(capacity) {}
+
+    /**
+     * @brief Add an event. Return false, dropping it, if the queue is full.
+     * Called by the strategy.
+     */
+    bool push(const CircuitbreakerStateChange& change)
+    {
+        if (not d_changes.push(change)) {
+            return false;
+        }
+        if (d_wakeUp) {
+            d_wakeUp->notifyIfSleeping();
+        }
+        return true;
+    }
+
+    /**
+     * @brief Remove the oldest event into `change`. Return false if the queue is empty.
+     * Called by the consumer.
+     */
+    bool pop(CircuitbreakerStateChange& change) { return d_changes.pop(change); }
+
+    /**
+     * @brief Whether the queue is empty.
+     * Called by the consumer.
+     */
+    bool empty() const { return d_changes.empty(); }
+
+private:
+    friend class StateChangeDispatcher;
+
+    StateChangeQueue(std::size_t capacity, std::shared_ptr<detail::StateChangeWakeUp> wakeUp)
+    : d_changes(capacity), d_wakeUp(std::move(wakeUp))
+    {
+    }
+
+    detail::SpscQueue<CircuitbreakerStateChange> d_changes;
+    std::shared_ptr<detail::StateChangeWakeUp> d_wakeUp;
+};
+
+/**
+ * @brief Deliver the state changes of circuit breaker strategies to an observer on a
+ *        background thread.
+ * @related resilient::ICircuitbreakerStrategy
+ *
+ * Each strategy gets its own queue with `newQueue()`. Changing state only pushes an event to
+ * the queue, without allocations, and calls which don't change state don't touch it.
+ * A background thread drains the queues and calls the observer, so it can be slow without
+ * delaying the calls. The thread sleeps while the queues are empty: only the push which finds
+ * it asleep takes a lock, to wake it up.
+ *
+ * If a queue is full when a strategy changes state the event is dropped.
+ *
+ * The destructor delivers the events already in the queues and joins the thread.
+ */
+class StateChangeDispatcher
+{
+public:
+    /**
+     * @brief The type of the function called with each state change.
+     */
+    using observer_type = std::function<void(const CircuitbreakerStateChange&)>;
+
+    /**
+     * @brief Construct a new StateChangeDispatcher object, starting its thread.
+     *
+     * @param observer Called on the background thread with each state change.
+     * @param queueCapacity How many events each queue can hold before dropping them.
+     */
+    explicit StateChangeDispatcher(observer_type observer, std::size_t queueCapacity = 64)
+    : d_observer(std::move(observer))
+    , d_queueCapacity(queueCapacity)
+    , d_wakeUp(std::make_shared<detail::StateChangeWakeUp>())
+    , d_stopping(false)
+    , d_thread([this]() { run(); })
+    {
+    }
+
+    StateChangeDispatcher(const StateChangeDispatcher&) = delete;
+    StateChangeDispatcher& operator=(const StateChangeDispatcher&) = delete;
+
+    ~StateChangeDispatcher()
+    {
+        {
+            std::lock_guard<std::mutex> guard{d_mutex};
+            d_stopping = true;
+        }
+        d_wakeUp->notify();
+        d_thread.join();
+    }
+
+    /**
+     * @brief Create a queue to pass to the `notifyStateChangesTo()` method of a strategy.
+     *
+     * The queue is forgotten once the dispatcher holds the only reference to it and it's empty.
+     */
+    std::shared_ptr<StateChangeQueue> newQueue()
+    {
+        std::shared_ptr<StateChangeQueue> queue{new StateChangeQueue(d_queueCapacity, d_wakeUp)};
+        {
+            std::lock_guard<std::mutex> guard{d_mutex};
+            d_queues.push_back(queue);
+        }
+        // Drain it from now on
+        d_wakeUp->notify();
+        return queue;
+    }
+
+private:
+    void run()
+    {
+        std::vector<std::shared_ptr<StateChangeQueue>> queues;
+        for (;;) {
+            bool stopping;
+            {
+                std::lock_guard<std::mutex> guard{d_mutex};
+                forgetUnusedQueues();
+                stopping = d_stopping;
+                queues = d_queues;
+            }
+
+            if (not drain(queues)) {
+                if (stopping) {
+                    return;
+                }
+                // Sleep until an event is pushed, a queue is created or the dispatcher stops
+                d_wakeUp->sleepUnless([&queues]() {
+                    return std::any_of(queues.begin(),
+                                       queues.end(),
+                                       [](const std::shared_ptr<StateChangeQueue>& queue) {
+                                           return not queue->empty();
+                                       });
+                });
+            }
+            queues.clear();
+        }
+    }
+
+    // Deliver the events in the queues. Return whether there were any.
+    bool drain(const std::vector<std::shared_ptr<StateChangeQueue>>& queues)
+    {
+        bool delivered = false;
+        CircuitbreakerStateChange change;
+        for (const auto& queue : queues) {
+            while (queue->pop(change)) {
+                d_observer(change);
+                delivered = true;
+            }
+        }
+        return delivered;
+    }
+
+    // Requires d_mutex to be held
+    void forgetUnusedQueues()
+    {
+        for (auto it = d_queues.begin(); it != d_queues.end();) {
+            if (it->use_count() == 1) {
+                // Nobody else can push to it: if it's empty it will stay empty.
+                // The fence makes the last push visible, as we saw its owner release it.
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if ((*it)->empty()) {
+                    it = d_queues.erase(it);
+                    continue;
+                }
+            }
+            ++it;
+        }
+    }
+
+    observer_type d_observer;
+    std::size_t d_queueCapacity;
+    std::shared_ptr<detail::StateChangeWakeUp> d_wakeUp;
+
+    std::mutex d_mutex;
+    bool d_stopping;
+    std::vector<std::shared_ptr<StateChangeQueue>> d_queues;
+
+    // Last, so that it starts when everything else is initialized
+    std::thread d_thread;
+};
+
+} // namespace resilient
@@ -1,8 +1,13 @@
 #pragma once
 
+#include <algorithm>
+#include <chrono>
+#include <iterator>
 #include <memory>
+#include <stdexcept>
 #include <type_traits>
 #include <utility>
+#include <vector>
 
 #include <resilient/common/variant.hpp>
 #include <resilient/detail/invoke.hpp>
@@ -12,6 +17,18 @@
 
 namespace resilient {
 
+/// @brief Error returned when acquiring a permit for the Ratelimiter takes too long.
+struct PermitAcquireTimeout
+{
+};
+
+/// @brief Error returned when an execution would exceed the rate limit.
+struct RateLimitExceeded
+{
+    /// How long to wait before an execution is allowed again.
+    std::chrono::nanoseconds retryAfter;
+};
+
 /**
  * @brief Interface to specify the algorithm the `Ratelimiter` should use.
  * @related resilient::Ratelimiter
@@ -56,6 +73,62 @@ public:
     virtual ~IRateLimiterStrategy() {}
 };
 
+/**
+ * @brief Interface of the strategies which can also acquire a permit without blocking.
+ * @related resilient::Ratelimiter
+ *
+ * Implementing it allows to use the strategy with `Ratelimiter::tryExecute()`.
+ *
+ * @tparam Permit The type of permits the strategy returns.
+ * @tparam Error The kind of error returned when acquire fails.
+ */
+template<typename Permit, typename Error>
+class INonBlockingRateLimiterStrategy : public IRateLimiterStrategy<Permit, Error>
+{
+public:
+    using typename IRateLimiterStrategy<Permit, Error>::permit_type;
+    using typename IRateLimiterStrategy<Permit, Error>::error_type;
+
+    /**
+     * @brief Acquire a single permit to execute a request, only if it's available right away.
+     *
+     * Unlike `acquire()` this call never blocks nor sleeps: if a permit is not available it
+     * returns the error immediately.
+     *
+     * @returns Either return a permit or an error. If a permit is returned `release()`
+     *          is called with the permit.
+     */
+    virtual Variant<permit_type, error_type> tryAcquire() = 0;
+};
+
+/**
+ * @brief Interface of the strategies which can acquire a permit for an execution of a given
+ *        cost, in addition to deriving from IRateLimiterStrategy.
+ * @related resilient::Ratelimiter
+ *
+ * Implementing it allows to use the strategy with `Ratelimiter::executeWeighted()`: an
+ * execution with weight `N` uses as much of the limit as `N` executions, atomically.
+ *
+ * @tparam Permit The type of permits the strategy returns.
+ * @tparam Error The kind of error returned when acquire fails.
+ */
+template<typename Permit, typename Error>
+class IWeightedRateLimiterStrategy
+{
+public:
+    /**
+     * @brief Acquire a single permit to execute a request which weighs `weight` executions.
+     *
+     * It behaves as `IRateLimiterStrategy::acquire()`. The returned permit is released with
+     * `IRateLimiterStrategy::release()`.
+     *
+     * @returns Either return a permit or an error.
+     */
+    virtual Variant<Permit, Error> acquire(unsigned long weight) = 0;
+
+    virtual ~IWeightedRateLimiterStrategy() {}
+};
+
 /**
  * @ingroup Policy
  * @brief Execute a `Task` limiting the times it can be executed following a strategy.
@@ -113,9 +186,193 @@ public:
      */
     template<typename Callable, typename... Args>
     return_type_t<Callable, Args...> execute(Callable&& callable, Args&&... args)
+    {
+        return executeWith(d_strategy->acquire(),
+                           std::forward<Callable>(callable),
+                           std::forward<Args>(args)...);
+    }
+
+    /**
+     * @brief Execute the task only if the strategy allows it right away, without ever blocking.
+     *
+     * If the strategy has no permit available the error is returned immediately: use it
+     * from threads which must not block, like the threads of an event loop.
+     *
+     * Requires the strategy to derive from INonBlockingRateLimiterStrategy.
+     *
+     * @param callable The task to execute
+     * @param args... The arguments to the task
+     * @return The result of invoking the task with the arguments
+     */
+    template<typename Callable, typename... Args>
+    return_type_t<Callable, Args...> tryExecute(Callable&& callable, Args&&... args)
+    {
+        static_assert(
+            std::is_convertible<Strategy*,
+                                INonBlockingRateLimiterStrategy<strategy_permit,
+                                                                strategy_error>*>::value,
+            "The strategy must derive from INonBlockingRateLimiterStrategy.");
+        return executeWith(d_strategy->tryAcquire(),
+                           std::forward<Callable>(callable),
+                           std::forward<Args>(args)...);
+    }
+
+    /**
+     * @brief Execute the task using `weight` units of the rate limit, to account for tasks
+     *        which cost more than others.
+     *
+     * Requires the strategy to derive from IWeightedRateLimiterStrategy.
+     *
+     * @param weight How many executions the task is worth.
+     * @param callable The task to execute
+     * @param args... The arguments to the task
+     * @return The result of invoking the task with the arguments
+     */
+    template<typename Callable, typename... Args>
+    return_type_t<Callable, Args...>
+    executeWeighted(unsigned long weight, Callable&& callable, Args&&... args)
+    {
+        static_assert(
+            std::is_convertible<Strategy*,
+                                IWeightedRateLimiterStrategy<strategy_permit,
+                                                             strategy_error>*>::value,
+            "The strategy must derive from IWeightedRateLimiterStrategy.");
+        return executeWith(d_strategy->acquire(weight),
+                           std::forward<Callable>(callable),
+                           std::forward<Args>(args)...);
+    }
+
+    /**
+     * @brief Execute the task using as many units of the rate limit as `weigh(args...)`
+     *        returns.
+     *
+     * Requires the strategy to derive from IWeightedRateLimiterStrategy.
+     *
+     * @param weigh Compute the weight of the task from the arguments, which it takes by const
+     *              reference.
+     * @param callable The task to execute
+     * @param args... The arguments to the task
+     * @return The result of invoking the task with the arguments
+     */
+    template<typename Weigh, typename Callable, typename... Args>
+    return_type_t<Callable, Args...>
+    executeWeightedBy(Weigh&& weigh, Callable&& callable, Args&&... args)
+    {
+        const unsigned long weight = detail::invoke(
+            std::forward<Weigh>(weigh), static_cast<const std::remove_reference_t<Args>&>(args)...);
+        return executeWeighted(weight,
+                               std::forward<Callable>(callable),
+                               std::forward<Args>(args)...);
+    }
+
+    /**
+     * @brief Execute the task once for each element of a range, acquiring a single permit for
+     *        all of them.
+     *
+     * The permit weighs as many executions as the elements, and it's acquired in a single call
+     * to the strategy and released after all the tasks ran: the cost of synchronizing with
+     * the strategy is paid once for the whole batch instead of once per task. Either all the
+     * tasks are allowed or none is: if the strategy doesn't allow them every result is the
+     * error of the strategy.
+     *
+     * The strategies of the library never allow a weight above their limit or burst: a batch
+     * larger than that is always rejected, it never waits nor runs. Split such batches with the
+     * overload taking `maxBatchWeight`.
+     *
+     * Requires the strategy to derive from IWeightedRateLimiterStrategy.
+     *
+     * @param first The first element of the range.
+     * @param last The end of the range.
+     * @param callable The task to execute, invoked with each element of the range.
+     * @return The results of invoking the task with each element, in order.
+     */
+    template<typename Iterator, typename Callable>
+    std::vector<return_type_t<Callable, typename std::iterator_traits<Iterator>::reference>>
+    executeBatch(Iterator first, Iterator last, Callable&& callable)
+    {
+        const auto size = static_cast<unsigned long>(std::distance(first, last));
+        return executeBatch(first, last, std::max(size, 1ul), std::forward<Callable>(callable));
+    }
+
+    /**
+     * @brief Execute the task once for each element of a range, acquiring a permit for each
+     *        chunk of at most `maxBatchWeight` elements.
+     *
+     * Each chunk is a batch as in the other overload: either all its tasks are allowed or none
+     * is. The chunks are acquired one after the other, so some can be allowed while others are
+     * rejected.
+     *
+     * Requires the strategy to derive from IWeightedRateLimiterStrategy.
+     *
+     * @param first The first element of the range.
+     * @param last The end of the range.
+     * @param maxBatchWeight The largest weight acquired at once. At least 1: pass at most the
+     *                       limit or burst of the strategy so that each chunk can be allowed.
+     * @param callable The task to execute, invoked with each element of the range.
+     * @return The results of invoking the task with each element, in order.
+     * @throw std::invalid_argument If `maxBatchWeight` is 0.
+     */
+    template<typename Iterator, typename Callable>
+    std::vector<return_type_t<Callable, typename std::iterator_traits<Iterator>::reference>>
+    executeBatch(Iterator first, Iterator last, unsigned long maxBatchWeight, Callable&& callable)
+    {
+        using result_type =
+            return_type_t<Callable, typename std::iterator_traits<Iterator>::reference>;
+        static_assert(
+            std::is_convertible<Strategy*,
+                                IWeightedRateLimiterStrategy<strategy_permit,
+                                                             strategy_error>*>::value,
+            "The strategy must derive from IWeightedRateLimiterStrategy.");
+        if (maxBatchWeight == 0) {
+            throw std::invalid_argument("A batch must weigh at least one execution");
+        }
+
+        auto remaining = static_cast<unsigned long>(std::distance(first, last));
+        std::vector<result_type> results;
+        results.reserve(remaining);
+        while (remaining > 0) {
+            const unsigned long size = std::min(remaining, maxBatchWeight);
+            Iterator chunkLast = std::next(
+                first, static_cast<typename std::iterator_traits<Iterator>::difference_type>(size));
+            executeChunk(first, chunkLast, size, callable, results);
+            first = chunkLast;
+            remaining -= size;
+        }
+        return results;
+    }
+
+private:
+    // Execute the `size` tasks of the range with a single permit, appending their results.
+    template<typename Iterator, typename Callable, typename Result>
+    void executeChunk(Iterator first,
+                      Iterator last,
+                      unsigned long size,
+                      Callable& callable,
+                      std::vector<Result>& results)
+    {
+        visit(detail::overload<void>(
+                  [this, &first, &last, &callable, &results](strategy_permit permit) {
+                      ReleaseGuard guard(*d_strategy, std::forward<strategy_permit>(permit));
+                      for (; first != last; ++first) {
+                          results.push_back(
+                              from_narrower_failable<Result>(detail::invoke(callable, *first)));
+                      }
+                  },
+                  [size, &results](strategy_error error) {
+                      for (unsigned long i = 0; i < size; i++) {
+                          results.push_back(from_failure<Result>(error));
+                      }
+                  }),
+              d_strategy->acquire(size));
+    }
+
+    template<typename Callable, typename... Args>
+    return_type_t<Callable, Args...>
+    executeWith(Variant<strategy_permit, strategy_error> maybePermit,
+                Callable&& callable,
+                Args&&... args)
     {
         using result_type = return_type_t<Callable, Args...>;
-        decltype(auto) maybePermit{d_strategy->acquire()};
         return visit(detail::overload<result_type>(
                          [this, &callable, &args...](strategy_permit permit) {
                              ReleaseGuard guard(*d_strategy, std::forward<strategy_permit>(permit));
@@ -127,10 +384,9 @@ public:
                              return from_failure<return_type_t<Callable, Args...>>(
                                  std::forward<strategy_error>(error));
                          }),
-                     std::forward<decltype(maybePermit)>(maybePermit));
+                     std::move(maybePermit));
     }
 
-private:
     std::unique_ptr<Strategy> d_strategy;
 };
 
@@ -0,0 +1,312 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <mutex>
+
+#include <resilient/common/variant.hpp>
+#include <resilient/policy/ratelimiter.hpp>
+
+namespace resilient {
+
+/// @brief A permit for an execution allowed by an `AdaptiveConcurrencyStrategy`.
+template<typename Clock>
+struct AdaptiveConcurrencyPermit
+{
+    /// When the execution was allowed, to measure its latency.
+    typename Clock::time_point start;
+    /// How many executions were running when it was allowed, including itself.
+    unsigned long inflight;
+};
+
+/// @brief Error returned when too many executions are already running.
+struct ConcurrencyLimitExceeded
+{
+    /// The limit at the time the execution was rejected.
+    unsigned long limit;
+};
+
+/**
+ * @brief Adapt the concurrency limit with additive increase and multiplicative decrease (AIMD).
+ * @related resilient::AdaptiveConcurrencyStrategy
+ *
+ * The limit grows by one every time an execution which used at least half of the limit is
+ * faster than `latencyThreshold`, and it's multiplied by `backoffRatio` every time an execution
+ * is slower.
+ *
+ * It reacts quickly to overload, but it needs to know what latency is too high.
+ */
+class AimdLimit
+{
+public:
+    /**
+     * @brief Construct a new AimdLimit object.
+     *
+     * @param latencyThreshold Executions slower than this signal overload.
+     * @param backoffRatio How much to reduce the limit on overload, between 0 and 1.
+     */
+    explicit AimdLimit(std::chrono::nanoseconds latencyThreshold, double backoffRatio = 0.9)
+    : d_latencyThreshold(latencyThreshold), d_backoffRatio(backoffRatio)
+    {
+    }
+
+    /**
+     * @brief Compute the new limit after an execution completed.
+     *
+     * @param limit The current limit.
+     * @param rtt The latency of the execution.
+     * @param inflight How many executions were running when it was allowed.
+     */
+    double update(double limit, std::chrono::nanoseconds rtt, unsigned long inflight)
+    {
+        if (rtt > d_latencyThreshold) {
+            return limit * d_backoffRatio;
+        }
+        // Don't grow a limit which is not used
+        if (inflight * 2 >= limit) {
+            return limit + 1;
+        }
+        return limit;
+    }
+
+private:
+    std::chrono::nanoseconds d_latencyThreshold;
+    double d_backoffRatio;
+};
+
+/**
+ * @brief Adapt the concurrency limit estimating the queue from the latency, like TCP Vegas.
+ * @related resilient::AdaptiveConcurrencyStrategy
+ *
+ * The lowest latency ever measured is taken as the latency without load. The executions
+ * exceeding what the service can process in parallel are estimated as
+ * `limit * (1 - minRtt / rtt)`: the limit grows by one while fewer than `alpha` executions are
+ * queued, and shrinks by one when more than `beta` are queued.
+ *
+ * It doesn't need to know the expected latency, but a permanent increase of the latency of
+ * the service is taken as overload.
+ */
+class VegasLimit
+{
+public:
+    /**
+     * @brief Construct a new VegasLimit object.
+     *
+     * @param alpha Grow the limit while fewer executions than this are queued.
+     * @param beta Shrink the limit when more executions than this are queued.
+     */
+    explicit VegasLimit(double alpha = 3, double beta = 6)
+    : d_alpha(alpha), d_beta(beta), d_minRtt(std::chrono::nanoseconds::max())
+    {
+    }
+
+    /**
+     * @brief Compute the new limit after an execution completed.
+     *
+     * @param limit The current limit.
+     * @param rtt The latency of the execution.
+     * @param inflight How many executions were running when it was allowed.
+     */
+    double update(double limit, std::chrono::nanoseconds rtt, unsigned long inflight)
+    {
+        if (rtt <= std::chrono::nanoseconds::zero()) {
+            return limit;
+        }
+        d_minRtt = std::min(d_minRtt, rtt);
+        const double queued =
+            limit * (1 - static_cast<double>(d_minRtt.count()) / rtt.count());
+        if (queued > d_beta) {
+            return limit - 1;
+        }
+        if (queued < d_alpha and inflight * 2 >= limit) {
+            return limit + 1;
+        }
+        return limit;
+    }
+
+private:
+    double d_alpha;
+    double d_beta;
+    std::chrono::nanoseconds d_minRtt;
+};
+
+/**
+ * @brief Adapt the concurrency limit following the gradient of the latency.
+ * @related resilient::AdaptiveConcurrencyStrategy
+ *
+ * The latency of each execution is compared with a long term average: the limit is scaled by
+ * their ratio (between 0.5 and 1) and `queueSize` is added to it, to leave room for growth.
+ * The new limit is smoothed with the previous one.
+ *
+ * Unlike `VegasLimit` it adapts to permanent changes of the latency of the service, since the
+ * average forgets old executions.
+ */
+class GradientLimit
+{
+public:
+    /**
+     * @brief Construct a new GradientLimit object.
+     *
+     * @param queueSize How many executions to allow above the estimated limit.
+     * @param smoothing How much a new limit weighs on the current one, between 0 and 1.
+     * @param longWindow How many executions the long term average latency roughly covers.
+     */
+    explicit GradientLimit(double queueSize = 4,
+                           double smoothing = 0.2,
+                           unsigned long longWindow = 100)
+    : d_queueSize(queueSize), d_smoothing(smoothing), d_longWindow(longWindow), d_longRtt(0)
+    {
+    }
+
+    /**
+     * @brief Compute the new limit after an execution completed.
+     *
+     * @param limit The current limit.
+     * @param rtt The latency of the execution.
+     * @param inflight How many executions were running when it was allowed.
+     */
+    double update(double limit, std::chrono::nanoseconds rtt, unsigned long inflight)
+    {
+        const double shortRtt = static_cast<double>(rtt.count());
+        if (shortRtt <= 0) {
+            return limit;
+        }
+        if (d_longRtt == 0) {
+            d_longRtt = shortRtt;
+        }
+        d_longRtt += (shortRtt - d_longRtt) / d_longWindow;
+        // After a long overload the average is high: let it recover quickly
+        if (d_longRtt > 2 * shortRtt) {
+            d_longRtt = (d_longRtt + shortRtt) / 2;
+        }
+
+        // Don't grow a limit which is not used
+        if (inflight * 2 < limit) {
+            return limit;
+        }
+        const double gradient = std::max(0.5, std::min(1.0, d_longRtt / shortRtt));
+        const double newLimit = limit * gradient + d_queueSize;
+        return limit * (1 - d_smoothing) + newLimit * d_smoothing;
+    }
+
+private:
+    double d_queueSize;
+    double d_smoothing;
+    unsigned long d_longWindow;
+    double d_longRtt;
+};
+
+/**
+ * @brief Allow at most a number of executions to happen at the same time, adapting the number
+ *        to the latency of the executions.
+ * @related resilient::IRateLimiterStrategy
+ *
+ * A fixed limit is either too low, wasting capacity, or too high, letting requests queue in the
+ * service when it slows down. This strategy measures the latency of every execution when its
+ * permit is released and lets `Limit` compute the new limit from it, between `minLimit` and
+ * `maxLimit`. `AimdLimit`, `VegasLimit` and `GradientLimit` are available.
+ *
+ * Executions above the limit are rejected immediately, without waiting.
+ *
+ * Acquiring a permit is a CAS on the count of running executions. The limit is updated under a
+ * lock when a permit is released.
+ *
+ * `Limit` must provide `double update(double limit, std::chrono::nanoseconds rtt,
+ * unsigned long inflight)`, returning the new limit after an execution completed.
+ *
+ * @tparam Limit The algorithm computing the limit.
+ * @tparam Clock The kind of clock to use when measuring time.
+ */
+template<typename Limit, typename Clock = std::chrono::steady_clock>
+class AdaptiveConcurrencyStrategy final
+: public INonBlockingRateLimiterStrategy<AdaptiveConcurrencyPermit<Clock>, ConcurrencyLimitExceeded>
+{
+public:
+    using Permit = AdaptiveConcurrencyPermit<Clock>;
+
+    /**
+     * @brief Construct a new AdaptiveConcurrencyStrategy object.
+     *
+     * @param limit The algorithm computing the limit.
+     * @param initialLimit The limit until the first execution completes.
+     * @param minLimit The lowest the limit can go. At least 1.
+     * @param maxLimit The highest the limit can go.
+     * @param clock An instance of the clock to use to measure time. Defaults to a default initialized one.
+     */
+    AdaptiveConcurrencyStrategy(Limit limit,
+                                unsigned long initialLimit,
+                                unsigned long minLimit,
+                                unsigned long maxLimit,
+                                Clock clock = Clock())
+    : d_minLimit(static_cast<double>(std::max(minLimit, 1ul)))
+    , d_maxLimit(static_cast<double>(std::max(maxLimit, minLimit)))
+    , d_clock(std::move(clock))
+    , d_algorithm(std::move(limit))
+    , d_exactLimit(std::max(d_minLimit, std::min(d_maxLimit, static_cast<double>(initialLimit))))
+    , d_limit(static_cast<unsigned long>(d_exactLimit))
+    , d_inflight(0)
+    {
+    }
+
+    Variant<Permit, ConcurrencyLimitExceeded> acquire() override;
+
+    /// `acquire()` never blocks: it's the same as `acquire()`.
+    Variant<Permit, ConcurrencyLimitExceeded> tryAcquire() override { return acquire(); }
+
+    void release(Permit permit) override;
+
+    /**
+     * @brief The current limit.
+     */
+    unsigned long limit() const { return d_limit.load(std::memory_order_relaxed); }
+
+private:
+    double d_minLimit;
+    double d_maxLimit;
+    Clock d_clock;
+
+    std::mutex d_mutex;
+    // Protected by d_mutex
+    Limit d_algorithm;
+    double d_exactLimit;
+
+    std::atomic<unsigned long> d_limit;
+    std::atomic<unsigned long> d_inflight;
+};
+
+template<typename Limit, typename Clock>
+Variant<AdaptiveConcurrencyPermit<Clock>, ConcurrencyLimitExceeded>
+AdaptiveConcurrencyStrategy<Limit, Clock>::acquire()
+{
+    unsigned long inflight = d_inflight.load(std::memory_order_relaxed);
+    for (;;) {
+        const unsigned long limit = d_limit.load(std::memory_order_relaxed);
+        if (inflight >= limit) {
+            return ConcurrencyLimitExceeded{limit};
+        }
+        if (d_inflight.compare_exchange_weak(inflight,
+                                             inflight + 1,
+                                             std::memory_order_acquire,
+                                             std::memory_order_relaxed))
+        {
+            return Permit{d_clock.now(), inflight + 1};
+        }
+    }
+}
+
+template<typename Limit, typename Clock>
+void AdaptiveConcurrencyStrategy<Limit, Clock>::release(Permit permit)
+{
+    const auto rtt = std::chrono::duration_cast<std::chrono::nanoseconds>(d_clock.now()
+                                                                          - permit.start);
+    d_inflight.fetch_sub(1, std::memory_order_release);
+
+    std::lock_guard<std::mutex> guard{d_mutex};
+    const double updated = d_algorithm.update(d_exactLimit, rtt, permit.inflight);
+    d_exactLimit = std::max(d_minLimit, std::min(d_maxLimit, updated));
+    d_limit.store(static_cast<unsigned long>(d_exactLimit), std::memory_order_relaxed);
+}
+
+} // namespace resilient
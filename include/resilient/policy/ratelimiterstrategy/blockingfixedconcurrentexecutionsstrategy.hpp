@@ -4,21 +4,30 @@
 #include <condition_variable>
 #include <mutex>
 
+#include <resilient/detail/waiterqueue.hpp>
 #include <resilient/policy/ratelimiter.hpp>
 
 namespace resilient {
 
-/// @brief Error returned when acquiring a permit for the Ratelimiter takes too long.
-struct PermitAcquireTimeout
-{
-};
-
 /// @brief A permit for a concurrent execution.
 struct MaxConcurrentPermit
 {
     // We don't require any state here
 };
 
+/**
+ * @brief The order in which blocked executions are allowed to run.
+ * @related resilient::BlockingFixedConcurrentExecutionsStrategy
+ */
+enum class WaitOrder
+{
+    /// Any of the waiting executions can run when a permit is released, as well as a new one
+    /// which didn't wait at all.
+    Unspecified,
+    /// A released permit is handed to the execution which has been waiting the longest.
+    Fifo
+};
+
 /**
  * @brief Allow at most a fixed amount of executions to happen at the same time
  * @related resilient::IRateLimiterStrategy
@@ -27,9 +36,13 @@ struct MaxConcurrentPermit
  * strategy allows immediately to execute.
  * If the limit has been reached then it waits for one of the current executions
  * to terminate up to a timeout, after which it returns an error.
+ *
+ * With `WaitOrder::Fifo` the waiting executions are kept in a queue and a released permit is
+ * handed directly to the oldest one, so that under saturation no execution waits longer than
+ * the ones which arrived after it. New executions don't take a permit while others are waiting.
  */
-class BlockingFixedConcurrentExecutionsStrategy
-: IRateLimiterStrategy<MaxConcurrentPermit, PermitAcquireTimeout>
+class BlockingFixedConcurrentExecutionsStrategy final
+: public INonBlockingRateLimiterStrategy<MaxConcurrentPermit, PermitAcquireTimeout>
 {
 public:
     /**
@@ -38,16 +51,23 @@ public:
      * @param maxConcurrentExecutions The maximum number of concurrent execution
      * @param maxWaitTime How long to wait to be allowed to run before returning
      *                    an error.
+     * @param order The order in which waiting executions are allowed to run.
      */
     BlockingFixedConcurrentExecutionsStrategy(unsigned long maxConcurrentExecutions,
-                                              std::chrono::microseconds maxWaitTime)
-    : d_remainingTokens(maxConcurrentExecutions), d_maxWaitTime(maxWaitTime)
+                                              std::chrono::microseconds maxWaitTime,
+                                              WaitOrder order = WaitOrder::Unspecified)
+    : d_remainingTokens(maxConcurrentExecutions)
+    , d_maxWaitTime(maxWaitTime)
+    , d_order(order)
     {
     }
 
     virtual Variant<MaxConcurrentPermit, PermitAcquireTimeout> acquire() override
     {
         std::unique_lock<std::mutex> lock(d_mutex);
+        if (d_order == WaitOrder::Fifo) {
+            return acquireInOrder(lock);
+        }
         if (d_condition.wait_for(lock, d_maxWaitTime, [this]() { return d_remainingTokens > 0; })) {
             --d_remainingTokens;
             return MaxConcurrentPermit{};
@@ -55,18 +75,59 @@ public:
         return PermitAcquireTimeout{};
     }
 
+    virtual Variant<MaxConcurrentPermit, PermitAcquireTimeout> tryAcquire() override
+    {
+        std::unique_lock<std::mutex> lock(d_mutex);
+        // With WaitOrder::Fifo there are no tokens left while someone is waiting
+        if (d_remainingTokens > 0) {
+            --d_remainingTokens;
+            return MaxConcurrentPermit{};
+        }
+        return PermitAcquireTimeout{};
+    }
+
     virtual void release(MaxConcurrentPermit) override
     {
         std::unique_lock<std::mutex> lock(d_mutex);
+        if (not d_waiters.empty()) {
+            // Hand the permit over: the waiter wakes up already owning it
+            d_waiters.grantOldest();
+            return;
+        }
         d_remainingTokens++;
         d_condition.notify_one();
     }
 
 private:
+    Variant<MaxConcurrentPermit, PermitAcquireTimeout>
+    acquireInOrder(std::unique_lock<std::mutex>& lock)
+    {
+        if (d_remainingTokens > 0) {
+            // Permits are only available when no one is waiting
+            --d_remainingTokens;
+            return MaxConcurrentPermit{};
+        }
+
+        detail::Waiter waiter;
+        d_waiters.push(waiter);
+
+        if (waiter.d_condition.wait_for(lock, d_maxWaitTime, [&waiter]() {
+                return waiter.d_granted;
+            }))
+        {
+            return MaxConcurrentPermit{};
+        }
+        d_waiters.remove(waiter);
+        return PermitAcquireTimeout{};
+    }
+
     std::mutex d_mutex;
     std::condition_variable d_condition;
     unsigned long d_remainingTokens;
     std::chrono::microseconds d_maxWaitTime;
+    WaitOrder d_order;
+    // Only used with WaitOrder::Fifo
+    detail::WaiterQueue d_waiters;
 };
 
-} // namespace resilient
\ No newline at end of file
+} // namespace resilient
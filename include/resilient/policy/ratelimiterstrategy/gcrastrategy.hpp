@@ -0,0 +1,161 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+
+#include <resilient/common/variant.hpp>
+#include <resilient/policy/ratelimiter.hpp>
+
+namespace resilient {
+
+/// @brief A permit for an execution allowed by a `GcraStrategy`.
+struct GcraPermit
+{
+    // Nothing to give back
+};
+
+namespace detail {
+
+/**
+ * The parameters of the generic cell rate algorithm, applied to a theoretical arrival time
+ * stored elsewhere so that many limits can share them.
+ *
+ * The theoretical arrival time (TAT) is when the next execution would be allowed if executions
+ * arrived exactly at the rate. An execution is allowed if it doesn't move the TAT further than
+ * `burst` emission intervals in the future.
+ */
+template<typename Clock>
+class GcraLimit
+{
+public:
+    using time_point = typename Clock::time_point;
+    using duration = typename Clock::duration;
+    using rep = typename duration::rep;
+
+    // Throw std::invalid_argument if `requests` is 0
+    GcraLimit(unsigned long requests, std::chrono::microseconds interval, unsigned long burst)
+    : d_emissionInterval(emissionInterval(requests, interval))
+    , d_tolerance(d_emissionInterval * static_cast<long>(burst))
+    {
+    }
+
+    /**
+     * Try to allow an execution weighing `weight` executions at `now`, updating `tat`.
+     * Return zero if allowed, otherwise how long to wait before retrying. `tat` is not
+     * modified when the execution is not allowed.
+     */
+    duration admit(std::atomic<rep>& tat, time_point now, unsigned long weight = 1) const;
+
+    /**
+     * Give back an execution weighing `weight` executions allowed by `admit()`, which didn't
+     * happen. Executions allowed after it keep their place.
+     */
+    void refund(std::atomic<rep>& tat, unsigned long weight = 1) const
+    {
+        tat.fetch_sub((d_emissionInterval * static_cast<long>(weight)).count(),
+                      std::memory_order_relaxed);
+    }
+
+private:
+    static duration emissionInterval(unsigned long requests, std::chrono::microseconds interval)
+    {
+        if (requests == 0) {
+            throw std::invalid_argument("At least one execution must be allowed every interval");
+        }
+        return std::chrono::duration_cast<duration>(interval) / static_cast<long>(requests);
+    }
+
+    duration d_emissionInterval;
+    duration d_tolerance;
+};
+
+template<typename Clock>
+typename GcraLimit<Clock>::duration GcraLimit<Clock>::admit(std::atomic<rep>& tat,
+                                                           time_point now,
+                                                           unsigned long weight) const
+{
+    const duration increment = d_emissionInterval * static_cast<long>(weight);
+    rep current = tat.load(std::memory_order_relaxed);
+    for (;;) {
+        // Unused capacity is not saved beyond the burst
+        const time_point next =
+            std::max(time_point(duration(current)), now) + increment;
+        const time_point limit = now + d_tolerance;
+        if (next > limit) {
+            return next - limit;
+        }
+        if (tat.compare_exchange_weak(current,
+                                      next.time_since_epoch().count(),
+                                      std::memory_order_relaxed,
+                                      std::memory_order_relaxed))
+        {
+            return duration::zero();
+        }
+    }
+}
+
+} // namespace detail
+
+/**
+ * @brief Allow executions at a fixed rate using the generic cell rate algorithm (GCRA).
+ * @related resilient::IRateLimiterStrategy
+ *
+ * Allows `requests` executions every `interval`, with bursts of up to `burst` executions.
+ * It behaves as a token bucket, but its whole state is a single 64 bit timestamp, the
+ * theoretical arrival time, updated with a CAS loop: it's cheap to keep one for each of many
+ * keys, and `acquire()` never blocks nor takes a lock.
+ *
+ * When an execution is not allowed the error tells how long to wait before retrying, so the
+ * caller can back off precisely.
+ *
+ * @tparam Clock The kind of clock to use when measuring time.
+ */
+template<typename Clock = std::chrono::steady_clock>
+class GcraStrategy final : public INonBlockingRateLimiterStrategy<GcraPermit, RateLimitExceeded>,
+                           public IWeightedRateLimiterStrategy<GcraPermit, RateLimitExceeded>
+{
+public:
+    /**
+     * @brief Construct a new GcraStrategy object, which allows a full burst right away.
+     *
+     * @param requests How many executions are allowed every `interval`.
+     * @param interval The interval over which `requests` executions are allowed.
+     * @param burst How many executions can happen at once after the strategy was not used for
+     *              a while.
+     * @param clock An instance of the clock to use to measure time. Defaults to a default initialized one.
+     * @throw std::invalid_argument If `requests` is 0.
+     */
+    GcraStrategy(unsigned long requests,
+                 std::chrono::microseconds interval,
+                 unsigned long burst,
+                 Clock clock = Clock())
+    : d_limit(requests, interval, burst), d_clock(std::move(clock)), d_tat(0)
+    {
+    }
+
+    Variant<GcraPermit, RateLimitExceeded> acquire() override { return acquire(1); }
+
+    /// An execution weighing more than `burst` is never allowed.
+    Variant<GcraPermit, RateLimitExceeded> acquire(unsigned long weight) override
+    {
+        const auto wait = d_limit.admit(d_tat, d_clock.now(), weight);
+        if (wait == Clock::duration::zero()) {
+            return GcraPermit{};
+        }
+        return RateLimitExceeded{std::chrono::duration_cast<std::chrono::nanoseconds>(wait)};
+    }
+
+    /// `acquire()` never blocks: it's the same as `acquire()`.
+    Variant<GcraPermit, RateLimitExceeded> tryAcquire() override { return acquire(); }
+
+    void release(GcraPermit) override {}
+
+private:
+    detail::GcraLimit<Clock> d_limit;
+    Clock d_clock;
+    std::atomic<typename Clock::duration::rep> d_tat;
+};
+
+} // namespace resilient
@@ -0,0 +1,188 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <utility>
+
+#include <resilient/common/variant.hpp>
+#include <resilient/detail/stripedmap.hpp>
+#include <resilient/policy/ratelimiter.hpp>
+#include <resilient/policy/ratelimiterstrategy/gcrastrategy.hpp>
+
+namespace resilient {
+
+/// @brief The rate allowed by a level of a `HierarchicalGcraStrategy`.
+struct GcraRate
+{
+    /// How many executions are allowed every `interval`.
+    unsigned long requests;
+    /// The interval over which `requests` executions are allowed.
+    std::chrono::microseconds interval;
+    /// How many executions can happen at once after a while without executions.
+    unsigned long burst;
+};
+
+template<typename Key, typename Clock, typename Hash>
+class KeyedGcraStrategy;
+
+/**
+ * @brief Limit the rate of all the executions and of the executions of each key, for example of
+ *        each tenant, at the same time.
+ * @related resilient::GcraStrategy
+ *
+ * An execution for a key is allowed only if both the global rate and the rate of the key allow
+ * it. Each rate is enforced with the generic cell rate algorithm, as in `GcraStrategy`.
+ *
+ * Stacking two rate limiters takes the global permit even when the key then rejects the
+ * execution. Here the key is checked first, and if the global rate then rejects the execution
+ * the reservation of the key is given back, so an execution rejected at any level doesn't use
+ * any of the rates. Until the reservation is given back, a concurrent execution for the same
+ * key can see it and be rejected.
+ *
+ * The state of each key is kept in a map bounded to about `maxKeys` keys, as in
+ * `CircuitbreakerRegistry`: keys without executions for `idleTimeout` are forgotten first when
+ * space is needed, or when `evictIdle()` is called. A forgotten key starts again with a full
+ * burst, so `idleTimeout` should be longer than `burst` emission intervals.
+ *
+ * Use `forKey()` to get a strategy for a `Ratelimiter` limiting the executions of one key.
+ *
+ * @tparam Key The type of the keys. Must be hashable by `Hash` and equality comparable.
+ * @tparam Clock The kind of clock to use when measuring time.
+ * @tparam Hash The hash function of the keys.
+ */
+template<typename Key, typename Clock = std::chrono::steady_clock, typename Hash = std::hash<Key>>
+class HierarchicalGcraStrategy
+{
+public:
+    /**
+     * @brief Construct a new HierarchicalGcraStrategy object, which allows full bursts right away.
+     *
+     * @param globalRate The rate of all the executions.
+     * @param keyRate The rate of the executions of each key.
+     * @param maxKeys The maximum number of keys to keep the state of.
+     * @param idleTimeout After how long without executions the state of a key can be forgotten.
+     * @param stripes In how many independently locked parts to divide the map of the keys.
+     * @param clock An instance of the clock to use to measure time. Defaults to a default initialized one.
+     * @throw std::invalid_argument If the `requests` of a rate is 0.
+     */
+    HierarchicalGcraStrategy(GcraRate globalRate,
+                             GcraRate keyRate,
+                             std::size_t maxKeys,
+                             std::chrono::microseconds idleTimeout,
+                             std::size_t stripes = 16,
+                             Clock clock = Clock())
+    : d_globalLimit(globalRate.requests, globalRate.interval, globalRate.burst)
+    , d_keyLimit(keyRate.requests, keyRate.interval, keyRate.burst)
+    , d_clock(std::move(clock))
+    , d_globalTat(0)
+    , d_keyTats(maxKeys, stripes, std::chrono::duration_cast<duration>(idleTimeout))
+    {
+    }
+
+    /**
+     * @brief Acquire a permit for an execution for the key, weighing `weight` executions.
+     *
+     * It never blocks: if the execution is not allowed the error tells how long to wait.
+     */
+    Variant<GcraPermit, RateLimitExceeded> acquire(const Key& key, unsigned long weight = 1);
+
+    /**
+     * @brief Release a permit returned by `acquire()`.
+     */
+    void release(GcraPermit) {}
+
+    /**
+     * @brief Create a strategy limiting the executions of `key`, for a `Ratelimiter`.
+     *
+     * This strategy must outlive the returned one.
+     */
+    std::unique_ptr<KeyedGcraStrategy<Key, Clock, Hash>> forKey(Key key)
+    {
+        return std::unique_ptr<KeyedGcraStrategy<Key, Clock, Hash>>(
+            new KeyedGcraStrategy<Key, Clock, Hash>(*this, std::move(key)));
+    }
+
+    /**
+     * @brief Forget the state of the keys without executions for `idleTimeout`.
+     *
+     * @return How many keys were forgotten.
+     */
+    std::size_t evictIdle() { return d_keyTats.evictIdle(d_clock.now()); }
+
+    /**
+     * @brief The number of keys the strategy keeps the state of.
+     */
+    std::size_t size() const { return d_keyTats.size(); }
+
+private:
+    using duration = typename Clock::duration;
+    using rep = typename duration::rep;
+
+    detail::GcraLimit<Clock> d_globalLimit;
+    detail::GcraLimit<Clock> d_keyLimit;
+    Clock d_clock;
+    std::atomic<rep> d_globalTat;
+    detail::StripedMap<Key, std::atomic<rep>, Clock, Hash> d_keyTats;
+};
+
+/**
+ * @brief The strategy limiting the executions of a key of a `HierarchicalGcraStrategy`.
+ * @related resilient::HierarchicalGcraStrategy
+ */
+template<typename Key, typename Clock = std::chrono::steady_clock, typename Hash = std::hash<Key>>
+class KeyedGcraStrategy final
+: public INonBlockingRateLimiterStrategy<GcraPermit, RateLimitExceeded>
+, public IWeightedRateLimiterStrategy<GcraPermit, RateLimitExceeded>
+{
+public:
+    KeyedGcraStrategy(HierarchicalGcraStrategy<Key, Clock, Hash>& strategy, Key key)
+    : d_strategy(strategy), d_key(std::move(key))
+    {
+    }
+
+    Variant<GcraPermit, RateLimitExceeded> acquire() override { return acquire(1); }
+
+    Variant<GcraPermit, RateLimitExceeded> acquire(unsigned long weight) override
+    {
+        return d_strategy.acquire(d_key, weight);
+    }
+
+    /// `acquire()` never blocks: it's the same as `acquire()`.
+    Variant<GcraPermit, RateLimitExceeded> tryAcquire() override { return acquire(1); }
+
+    void release(GcraPermit permit) override { d_strategy.release(permit); }
+
+private:
+    HierarchicalGcraStrategy<Key, Clock, Hash>& d_strategy;
+    Key d_key;
+};
+
+template<typename Key, typename Clock, typename Hash>
+Variant<GcraPermit, RateLimitExceeded>
+HierarchicalGcraStrategy<Key, Clock, Hash>::acquire(const Key& key, unsigned long weight)
+{
+    const auto now = d_clock.now();
+    std::shared_ptr<std::atomic<rep>> keyTat =
+        d_keyTats.getOrCreate(key, now, [](const Key&) {
+            return std::make_shared<std::atomic<rep>>(0);
+        });
+
+    // Check the key first: most rejections come from a single key exceeding its rate, and
+    // they don't need to touch the global state shared by all the threads.
+    const duration keyWait = d_keyLimit.admit(*keyTat, now, weight);
+    if (keyWait != duration::zero()) {
+        return RateLimitExceeded{std::chrono::duration_cast<std::chrono::nanoseconds>(keyWait)};
+    }
+    const duration globalWait = d_globalLimit.admit(d_globalTat, now, weight);
+    if (globalWait != duration::zero()) {
+        d_keyLimit.refund(*keyTat, weight);
+        return RateLimitExceeded{
+            std::chrono::duration_cast<std::chrono::nanoseconds>(globalWait)};
+    }
+    return GcraPermit{};
+}
+
+} // namespace resilient
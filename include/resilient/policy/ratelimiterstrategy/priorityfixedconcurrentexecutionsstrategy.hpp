@@ -0,0 +1,314 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+
+#include <resilient/detail/waiterqueue.hpp>
+#include <resilient/policy/ratelimiter.hpp>
+
+namespace resilient {
+
+/// @brief A permit for a concurrent execution of a priority class.
+struct PriorityPermit
+{
+    /// The priority class of the execution.
+    std::size_t priority;
+};
+
+/**
+ * @brief How the executions of a priority class of a `PriorityFixedConcurrentExecutionsStrategy`
+ *        are admitted.
+ */
+struct PriorityClass
+{
+    /// How long an execution of the class waits to be allowed to run before returning an error.
+    /// Classes which should be shed first under saturation should wait little.
+    std::chrono::microseconds maxWaitTime;
+    /// How many of the permits the class is guaranteed while it has waiting executions, even if
+    /// executions of higher priority are waiting too.
+    unsigned long reservedPermits = 0;
+    /// How many permits the class can use at most, to leave the others to higher priorities.
+    unsigned long maxPermits = std::numeric_limits<unsigned long>::max();
+};
+
+/// @brief Statistics about the executions of a priority class.
+struct PriorityClassStatistics
+{
+    /// How many executions were allowed to run.
+    unsigned long acquired = 0;
+    /// How many executions timed out waiting.
+    unsigned long timedOut = 0;
+    /// How long the executions allowed to run waited in total.
+    std::chrono::nanoseconds totalWaitTime{0};
+    /// The longest wait of an execution allowed to run.
+    std::chrono::nanoseconds maxWaitTime{0};
+};
+
+template<typename Clock>
+class PriorityClassStrategy;
+
+/**
+ * @brief Allow at most a fixed amount of executions to happen at the same time, serving the
+ *        waiting executions by priority.
+ * @related resilient::BlockingFixedConcurrentExecutionsStrategy
+ *
+ * It behaves as `BlockingFixedConcurrentExecutionsStrategy` with `WaitOrder::Fifo`, but each
+ * execution belongs to a priority class, 0 being the highest priority. The permits are shared
+ * by all the classes: when one is released it's handed to the oldest waiting execution of the
+ * highest priority class which can take it, so health checks and user-facing calls don't queue
+ * behind batch jobs.
+ *
+ * To avoid starving the lower priorities a class can be guaranteed some of the permits: while it
+ * has waiting executions and it's using fewer than its reserved permits it's served first.
+ * A class can also be limited in how many permits it uses, and in how long it waits, so that
+ * it's shed first under saturation.
+ *
+ * The strategy keeps statistics about the waits of each class.
+ *
+ * Use `forPriority()` to get a strategy for a `Ratelimiter` running executions of one class.
+ *
+ * @tparam Clock The kind of clock to use when measuring the wait times.
+ */
+template<typename Clock = std::chrono::steady_clock>
+class PriorityFixedConcurrentExecutionsStrategy
+{
+public:
+    /**
+     * @brief Construct a new PriorityFixedConcurrentExecutionsStrategy object
+     *
+     * @param maxConcurrentExecutions The maximum number of concurrent execution, of all classes.
+     * @param classes The priority classes, from the highest priority to the lowest.
+     * @param clock An instance of the clock to use to measure time. Defaults to a default initialized one.
+     */
+    PriorityFixedConcurrentExecutionsStrategy(unsigned long maxConcurrentExecutions,
+                                              std::vector<PriorityClass> classes,
+                                              Clock clock = Clock())
+    : d_maxConcurrentExecutions(maxConcurrentExecutions)
+    , d_running(0)
+    , d_classes(classes.size())
+    , d_clock(std::move(clock))
+    {
+        for (std::size_t priority = 0; priority < classes.size(); priority++) {
+            d_classes[priority].d_config = classes[priority];
+        }
+    }
+
+    /**
+     * @brief Acquire a permit for an execution of the priority class, waiting up to the
+     *        `maxWaitTime` of the class.
+     *
+     * @throw std::invalid_argument If there is no such priority class.
+     */
+    Variant<PriorityPermit, PermitAcquireTimeout> acquire(std::size_t priority);
+
+    /**
+     * @brief Acquire a permit for an execution of the priority class only if it's available
+     *        right away.
+     *
+     * @throw std::invalid_argument If there is no such priority class.
+     */
+    Variant<PriorityPermit, PermitAcquireTimeout> tryAcquire(std::size_t priority)
+    {
+        checkPriority(priority);
+        std::lock_guard<std::mutex> guard{d_mutex};
+        if (not canRun(priority)) {
+            return PermitAcquireTimeout{};
+        }
+        startRunning(priority, std::chrono::nanoseconds::zero());
+        return PriorityPermit{priority};
+    }
+
+    /**
+     * @brief Release a permit returned by `acquire()` or `tryAcquire()`.
+     */
+    void release(PriorityPermit permit)
+    {
+        std::lock_guard<std::mutex> guard{d_mutex};
+        d_running--;
+        d_classes[permit.priority].d_running--;
+        handOver();
+    }
+
+    /**
+     * @brief The statistics of the priority class.
+     *
+     * @throw std::invalid_argument If there is no such priority class.
+     */
+    PriorityClassStatistics statistics(std::size_t priority) const
+    {
+        checkPriority(priority);
+        std::lock_guard<std::mutex> guard{d_mutex};
+        return d_classes[priority].d_statistics;
+    }
+
+    /**
+     * @brief Create a strategy running executions of the priority class, for a `Ratelimiter`.
+     *
+     * This strategy must outlive the returned one.
+     *
+     * @throw std::invalid_argument If there is no such priority class.
+     */
+    std::unique_ptr<PriorityClassStrategy<Clock>> forPriority(std::size_t priority)
+    {
+        checkPriority(priority);
+        return std::unique_ptr<PriorityClassStrategy<Clock>>(
+            new PriorityClassStrategy<Clock>(*this, priority));
+    }
+
+private:
+    struct Class
+    {
+        PriorityClass d_config;
+        unsigned long d_running = 0;
+        detail::WaiterQueue d_waiters;
+        PriorityClassStatistics d_statistics;
+    };
+
+    // The classes never change after construction: no need for d_mutex.
+    void checkPriority(std::size_t priority) const
+    {
+        if (priority >= d_classes.size()) {
+            throw std::invalid_argument("There is no such priority class");
+        }
+    }
+
+    // All the functions below require d_mutex.
+
+    bool canRun(std::size_t priority) const
+    {
+        return d_running < d_maxConcurrentExecutions
+               and d_classes[priority].d_running < d_classes[priority].d_config.maxPermits;
+    }
+
+    void startRunning(std::size_t priority, std::chrono::nanoseconds waited)
+    {
+        d_running++;
+        Class& priorityClass = d_classes[priority];
+        priorityClass.d_running++;
+        priorityClass.d_statistics.acquired++;
+        priorityClass.d_statistics.totalWaitTime += waited;
+        priorityClass.d_statistics.maxWaitTime =
+            std::max(priorityClass.d_statistics.maxWaitTime, waited);
+    }
+
+    // The class whose oldest waiter should get the next permit, or the number of classes if
+    // no waiter can run.
+    std::size_t nextToRun() const;
+
+    // Hand the available permits to the waiters which can run. After it returns the waiting
+    // executions can't run, so new executions can take a permit when one is available without
+    // overtaking anyone.
+    void handOver();
+
+    mutable std::mutex d_mutex;
+    unsigned long d_maxConcurrentExecutions;
+    unsigned long d_running;
+    std::vector<Class> d_classes;
+    Clock d_clock;
+};
+
+/**
+ * @brief The strategy running the executions of a priority class of a
+ *        `PriorityFixedConcurrentExecutionsStrategy`.
+ * @related resilient::PriorityFixedConcurrentExecutionsStrategy
+ */
+template<typename Clock = std::chrono::steady_clock>
+class PriorityClassStrategy final
+: public INonBlockingRateLimiterStrategy<PriorityPermit, PermitAcquireTimeout>
+{
+public:
+    PriorityClassStrategy(PriorityFixedConcurrentExecutionsStrategy<Clock>& strategy,
+                          std::size_t priority)
+    : d_strategy(strategy), d_priority(priority)
+    {
+    }
+
+    Variant<PriorityPermit, PermitAcquireTimeout> acquire() override
+    {
+        return d_strategy.acquire(d_priority);
+    }
+
+    Variant<PriorityPermit, PermitAcquireTimeout> tryAcquire() override
+    {
+        return d_strategy.tryAcquire(d_priority);
+    }
+
+    void release(PriorityPermit permit) override { d_strategy.release(permit); }
+
+private:
+    PriorityFixedConcurrentExecutionsStrategy<Clock>& d_strategy;
+    std::size_t d_priority;
+};
+
+template<typename Clock>
+Variant<PriorityPermit, PermitAcquireTimeout>
+PriorityFixedConcurrentExecutionsStrategy<Clock>::acquire(std::size_t priority)
+{
+    checkPriority(priority);
+    std::unique_lock<std::mutex> lock{d_mutex};
+    // Waiting executions can't run: taking the permit doesn't overtake them
+    if (canRun(priority)) {
+        startRunning(priority, std::chrono::nanoseconds::zero());
+        return PriorityPermit{priority};
+    }
+
+    Class& priorityClass = d_classes[priority];
+    const auto start = d_clock.now();
+    detail::Waiter waiter;
+    priorityClass.d_waiters.push(waiter);
+    if (waiter.d_condition.wait_for(lock, priorityClass.d_config.maxWaitTime, [&waiter]() {
+            return waiter.d_granted;
+        }))
+    {
+        // handOver() already counted the execution as running
+        const auto waited = std::chrono::duration_cast<std::chrono::nanoseconds>(d_clock.now()
+                                                                                 - start);
+        priorityClass.d_statistics.totalWaitTime += waited;
+        priorityClass.d_statistics.maxWaitTime =
+            std::max(priorityClass.d_statistics.maxWaitTime, waited);
+        return PriorityPermit{priority};
+    }
+    priorityClass.d_waiters.remove(waiter);
+    priorityClass.d_statistics.timedOut++;
+    return PermitAcquireTimeout{};
+}
+
+template<typename Clock>
+std::size_t PriorityFixedConcurrentExecutionsStrategy<Clock>::nextToRun() const
+{
+    // First the classes which are using less than their reserved permits, then by priority
+    for (std::size_t priority = 0; priority < d_classes.size(); priority++) {
+        const Class& priorityClass = d_classes[priority];
+        if (not priorityClass.d_waiters.empty()
+            and priorityClass.d_running < priorityClass.d_config.reservedPermits
+            and canRun(priority))
+        {
+            return priority;
+        }
+    }
+    for (std::size_t priority = 0; priority < d_classes.size(); priority++) {
+        if (not d_classes[priority].d_waiters.empty() and canRun(priority)) {
+            return priority;
+        }
+    }
+    return d_classes.size();
+}
+
+template<typename Clock>
+void PriorityFixedConcurrentExecutionsStrategy<Clock>::handOver()
+{
+    for (std::size_t priority = nextToRun(); priority < d_classes.size(); priority = nextToRun())
+    {
+        // The waiter records how long it waited when it wakes up
+        startRunning(priority, std::chrono::nanoseconds::zero());
+        d_classes[priority].d_waiters.grantOldest();
+    }
+}
+
+} // namespace resilient
@@ -0,0 +1,111 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+
+#include <resilient/common/variant.hpp>
+#include <resilient/policy/ratelimiter.hpp>
+
+namespace resilient {
+
+/// @brief A permit for an execution allowed by a `SlidingLogStrategy`.
+struct SlidingLogPermit
+{
+    // Nothing to give back
+};
+
+/**
+ * @brief Allow at most a number of executions in any window of time, exactly.
+ * @related resilient::IRateLimiterStrategy
+ *
+ * The strategy remembers when the last `limit` executions happened, in a ring buffer allocated
+ * at construction. An execution is allowed only if the oldest of them is out of the window
+ * ending now, so the limit is never exceeded in any window, wherever it starts.
+ *
+ * The memory used grows with the limit: use `SlidingWindowCounterStrategy` for large limits
+ * where an estimate is enough.
+ *
+ * @tparam Clock The kind of clock to use when measuring time.
+ */
+template<typename Clock = std::chrono::steady_clock>
+class SlidingLogStrategy final
+: public INonBlockingRateLimiterStrategy<SlidingLogPermit, RateLimitExceeded>
+, public IWeightedRateLimiterStrategy<SlidingLogPermit, RateLimitExceeded>
+{
+public:
+    /**
+     * @brief Construct a new SlidingLogStrategy object.
+     *
+     * @param limit How many executions are allowed in any `window`.
+     * @param window The duration of the window.
+     * @param clock An instance of the clock to use to measure time. Defaults to a default initialized one.
+     */
+    SlidingLogStrategy(std::size_t limit, std::chrono::microseconds window, Clock clock = Clock())
+    : d_limit(limit)
+    , d_window(std::chrono::duration_cast<duration>(window))
+    , d_clock(std::move(clock))
+    , d_log(new time_point[limit])
+    , d_oldest(0)
+    , d_size(0)
+    {
+    }
+
+    Variant<SlidingLogPermit, RateLimitExceeded> acquire() override { return acquire(1); }
+
+    /// An execution weighing `N` takes `N` entries of the log. An execution weighing more than
+    /// `limit` is never allowed.
+    Variant<SlidingLogPermit, RateLimitExceeded> acquire(unsigned long weight) override;
+
+    /// `acquire()` only waits for the lock: it's the same as `acquire()`.
+    Variant<SlidingLogPermit, RateLimitExceeded> tryAcquire() override { return acquire(); }
+
+    void release(SlidingLogPermit) override {}
+
+private:
+    using time_point = typename Clock::time_point;
+    using duration = typename Clock::duration;
+
+    std::size_t d_limit;
+    duration d_window;
+    Clock d_clock;
+
+    std::mutex d_mutex;
+    // Ring buffer with the times of the last executions, starting from the oldest
+    std::unique_ptr<time_point[]> d_log;
+    std::size_t d_oldest;
+    std::size_t d_size;
+};
+
+template<typename Clock>
+Variant<SlidingLogPermit, RateLimitExceeded>
+SlidingLogStrategy<Clock>::acquire(unsigned long weight)
+{
+    if (d_limit == 0 or weight > d_limit) {
+        return RateLimitExceeded{std::chrono::nanoseconds::max()};
+    }
+
+    std::lock_guard<std::mutex> guard{d_mutex};
+    // Read the time with the lock held, so that the log stays sorted
+    const time_point now = d_clock.now();
+    const std::size_t free = d_limit - d_size;
+    if (weight > free) {
+        // The oldest executions taking the entries we need must be out of the window
+        const std::size_t toForget = weight - free;
+        const time_point endOfWindow = d_log[(d_oldest + toForget - 1) % d_limit] + d_window;
+        if (endOfWindow > now) {
+            return RateLimitExceeded{
+                std::chrono::duration_cast<std::chrono::nanoseconds>(endOfWindow - now)};
+        }
+        d_oldest = (d_oldest + toForget) % d_limit;
+        d_size -= toForget;
+    }
+    for (std::size_t i = 0; i < weight; i++) {
+        d_log[(d_oldest + d_size) % d_limit] = now;
+        d_size++;
+    }
+    return SlidingLogPermit{};
+}
+
+} // namespace resilient
@@ -0,0 +1,203 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <stdexcept>
+
+#include <resilient/common/variant.hpp>
+#include <resilient/policy/ratelimiter.hpp>
+
+namespace resilient {
+
+/// @brief A permit for an execution allowed by a `SlidingWindowCounterStrategy`.
+struct SlidingWindowCounterPermit
+{
+    // Nothing to give back
+};
+
+/**
+ * @brief Allow at most a number of executions in a window of time sliding with the current time,
+ *        estimated from the counts of the current and previous window.
+ * @related resilient::IRateLimiterStrategy
+ *
+ * Time is divided in fixed windows. The executions in the sliding window ending now are
+ * estimated as the executions in the current fixed window, plus the executions of the previous
+ * fixed window weighted by how much of it overlaps the sliding window. Unlike a token bucket it
+ * doesn't allow bursts above the limit across the boundary of two windows.
+ *
+ * The estimate assumes the executions of the previous window were evenly spread: use
+ * `SlidingLogStrategy` when the limit must never be exceeded.
+ *
+ * The state is a single atomic word, updated with a CAS loop, holding the index of the current
+ * window and the two counts. The limit can be at most 2^20 - 1 executions.
+ *
+ * @tparam Clock The kind of clock to use when measuring time.
+ */
+template<typename Clock = std::chrono::steady_clock>
+class SlidingWindowCounterStrategy final
+: public INonBlockingRateLimiterStrategy<SlidingWindowCounterPermit, RateLimitExceeded>
+, public IWeightedRateLimiterStrategy<SlidingWindowCounterPermit, RateLimitExceeded>
+{
+public:
+    /**
+     * @brief Construct a new SlidingWindowCounterStrategy object.
+     *
+     * @param limit How many executions are allowed in any `window`. At most 2^20 - 1.
+     * @param window The duration of the window.
+     * @param clock An instance of the clock to use to measure time. Defaults to a default initialized one.
+     * @throw std::invalid_argument If `limit` can't be counted in the state word, or if
+     *        `window` is not positive.
+     */
+    SlidingWindowCounterStrategy(unsigned long limit,
+                                 std::chrono::microseconds window,
+                                 Clock clock = Clock())
+    : d_limit(limit)
+    , d_window(windowDuration(window))
+    , d_clock(std::move(clock))
+    , d_state(pack(indexAt(d_clock.now().time_since_epoch()), 0, 0))
+    {
+        if (limit > MaxLimit) {
+            throw std::invalid_argument("The limit must be at most 2^20 - 1 executions");
+        }
+    }
+
+    Variant<SlidingWindowCounterPermit, RateLimitExceeded> acquire() override
+    {
+        return acquire(1);
+    }
+
+    /// An execution weighing more than `limit` is never allowed.
+    Variant<SlidingWindowCounterPermit, RateLimitExceeded> acquire(unsigned long weight) override;
+
+    /// `acquire()` never blocks: it's the same as `acquire()`.
+    Variant<SlidingWindowCounterPermit, RateLimitExceeded> tryAcquire() override
+    {
+        return acquire();
+    }
+
+    void release(SlidingWindowCounterPermit) override {}
+
+private:
+    using duration = typename Clock::duration;
+    using word = std::uint64_t;
+
+    // Layout of the state word:
+    //  - bits [0, 20)  the executions in the current window
+    //  - bits [20, 40) the executions in the previous window
+    //  - bits [40, 64) the index of the current window, modulo 2^24
+    enum : word
+    {
+        CountBits = 20,
+        CountMask = (word(1) << CountBits) - 1,
+        IndexShift = 2 * CountBits,
+        IndexMask = (word(1) << (64 - IndexShift)) - 1,
+        // The counts must not overflow into the next field
+        MaxLimit = CountMask
+    };
+
+    static word currentOf(word state) { return state & CountMask; }
+    static word previousOf(word state) { return (state >> CountBits) & CountMask; }
+    static word indexOf(word state) { return state >> IndexShift; }
+    static word pack(word index, word current, word previous)
+    {
+        return ((index & IndexMask) << IndexShift) | (previous << CountBits) | current;
+    }
+
+    // Validated here, as the constructor divides by it before its body runs
+    static duration windowDuration(std::chrono::microseconds window)
+    {
+        const duration converted = std::chrono::duration_cast<duration>(window);
+        if (converted <= duration::zero()) {
+            throw std::invalid_argument("The window must be longer than zero");
+        }
+        return converted;
+    }
+
+    word indexAt(duration sinceEpoch) const
+    {
+        return static_cast<word>(sinceEpoch / d_window) & IndexMask;
+    }
+
+    // How long to wait before an execution weighing `weight` fits in the window.
+    std::chrono::nanoseconds
+    retryAfter(double current, double previous, double elapsed, unsigned long weight) const;
+
+    unsigned long d_limit;
+    duration d_window;
+    Clock d_clock;
+    std::atomic<word> d_state;
+};
+
+template<typename Clock>
+Variant<SlidingWindowCounterPermit, RateLimitExceeded>
+SlidingWindowCounterStrategy<Clock>::acquire(unsigned long weight)
+{
+    if (weight > d_limit) {
+        return RateLimitExceeded{std::chrono::nanoseconds::max()};
+    }
+    const duration sinceEpoch = d_clock.now().time_since_epoch();
+    const word index = indexAt(sinceEpoch);
+    // How much of the current window passed, between 0 and 1
+    const double elapsed =
+        static_cast<double>((sinceEpoch % d_window).count()) / d_window.count();
+
+    word state = d_state.load(std::memory_order_relaxed);
+    for (;;) {
+        word current = currentOf(state);
+        word previous = previousOf(state);
+        word storedIndex = indexOf(state);
+        const word behind = (index - storedIndex) & IndexMask;
+        if (behind == 1) {
+            previous = current;
+            current = 0;
+            storedIndex = index;
+        }
+        else if (behind != 0 and behind != IndexMask)
+        {
+            // More than a window passed since the last execution
+            previous = 0;
+            current = 0;
+            storedIndex = index;
+        }
+        // Otherwise the window is the same, or another thread which read the time after us
+        // already moved to the next one: count in the newer window.
+
+        const double estimate = previous * (1 - elapsed) + current;
+        if (estimate + weight > d_limit) {
+            return RateLimitExceeded{retryAfter(current, previous, elapsed, weight)};
+        }
+        if (d_state.compare_exchange_weak(state,
+                                          pack(storedIndex, current + weight, previous),
+                                          std::memory_order_relaxed,
+                                          std::memory_order_relaxed))
+        {
+            return SlidingWindowCounterPermit{};
+        }
+    }
+}
+
+template<typename Clock>
+std::chrono::nanoseconds SlidingWindowCounterStrategy<Clock>::retryAfter(
+    double current, double previous, double elapsed, unsigned long weight) const
+{
+    const double allowed = static_cast<double>(d_limit - weight);
+    // The fraction of a window to wait
+    double wait;
+    if (current <= allowed and previous > 0) {
+        // Wait for the previous window to slide out enough
+        wait = 1 - (allowed - current) / previous - elapsed;
+    }
+    else
+    {
+        // The current window is full: wait for it to become the previous one and slide out
+        wait = (1 - elapsed) + (current > 0 ? 1 - allowed / current : 0);
+    }
+    const auto window = std::chrono::duration_cast<std::chrono::nanoseconds>(d_window);
+    return std::chrono::nanoseconds(static_cast<std::chrono::nanoseconds::rep>(
+        std::ceil(std::max(wait, 0.0) * window.count())));
+}
+
+} // namespace resilient
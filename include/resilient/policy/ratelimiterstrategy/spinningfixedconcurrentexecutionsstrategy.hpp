@@ -0,0 +1,150 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <limits>
+#include <stdexcept>
+
+#include <resilient/detail/futex.hpp>
+#include <resilient/policy/ratelimiter.hpp>
+#include <resilient/policy/ratelimiterstrategy/blockingfixedconcurrentexecutionsstrategy.hpp>
+
+namespace resilient {
+
+/**
+ * @brief Allow at most a fixed amount of executions to happen at the same time, spinning
+ *        for a while before blocking.
+ * @related resilient::IRateLimiterStrategy
+ *
+ * It behaves as `BlockingFixedConcurrentExecutionsStrategy`, but it's tuned for executions
+ * which hold the permit for a few microseconds, where blocking on a mutex and a condition
+ * variable costs more than the execution itself.
+ *
+ * The permits are an atomic counter: if one is available it's taken with a CAS, without
+ * locking. Otherwise the execution spins for up to `spinTime`, hoping a permit is released
+ * soon, and only then it blocks on a futex until a permit is released or `maxWaitTime` passed.
+ * Releasing a permit only makes a system call when some execution is blocked.
+ *
+ * Waiting executions are not allowed to run in any specific order.
+ */
+class SpinningFixedConcurrentExecutionsStrategy final
+: public INonBlockingRateLimiterStrategy<MaxConcurrentPermit, PermitAcquireTimeout>
+{
+public:
+    /**
+     * @brief Construct a new SpinningFixedConcurrentExecutionsStrategy object
+     *
+     * @param maxConcurrentExecutions The maximum number of concurrent execution. At most INT_MAX.
+     * @param maxWaitTime How long to wait to be allowed to run before returning
+     *                    an error, including the time spent spinning.
+     * @param spinTime How long to spin waiting for a permit before blocking.
+     *                 Zero blocks right away.
+     *
+     * @throw std::invalid_argument If `maxConcurrentExecutions` is larger than INT_MAX.
+     */
+    SpinningFixedConcurrentExecutionsStrategy(unsigned long maxConcurrentExecutions,
+                                              std::chrono::microseconds maxWaitTime,
+                                              std::chrono::microseconds spinTime =
+                                                  std::chrono::microseconds(20))
+    : d_remainingTokens(initialTokens(maxConcurrentExecutions))
+    , d_waiters(0)
+    , d_maxWaitTime(maxWaitTime)
+    , d_spinTime(spinTime)
+    {
+    }
+
+    Variant<MaxConcurrentPermit, PermitAcquireTimeout> acquire() override;
+
+    Variant<MaxConcurrentPermit, PermitAcquireTimeout> tryAcquire() override
+    {
+        if (tryTakeToken()) {
+            return MaxConcurrentPermit{};
+        }
+        return PermitAcquireTimeout{};
+    }
+
+    void release(MaxConcurrentPermit) override
+    {
+        d_remainingTokens.value().fetch_add(1, std::memory_order_seq_cst);
+        // Pairs with the increment of the waiters before they check the tokens: either they see
+        // the token or we see them.
+        if (d_waiters.load(std::memory_order_seq_cst) > 0) {
+            d_remainingTokens.wakeOne();
+        }
+    }
+
+private:
+    using clock = std::chrono::steady_clock;
+
+    // The futex word is an int: larger values would wrap
+    static int initialTokens(unsigned long maxConcurrentExecutions)
+    {
+        if (maxConcurrentExecutions > static_cast<unsigned long>(std::numeric_limits<int>::max()))
+        {
+            throw std::invalid_argument("At most INT_MAX concurrent executions are supported");
+        }
+        return static_cast<int>(maxConcurrentExecutions);
+    }
+
+    bool tryTakeToken()
+    {
+        int tokens = d_remainingTokens.value().load(std::memory_order_relaxed);
+        while (tokens > 0) {
+            if (d_remainingTokens.value().compare_exchange_weak(tokens,
+                                                                tokens - 1,
+                                                                std::memory_order_acquire,
+                                                                std::memory_order_relaxed))
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    detail::FutexWord d_remainingTokens;
+    std::atomic<int> d_waiters;
+    std::chrono::microseconds d_maxWaitTime;
+    std::chrono::microseconds d_spinTime;
+};
+
+inline Variant<MaxConcurrentPermit, PermitAcquireTimeout>
+SpinningFixedConcurrentExecutionsStrategy::acquire()
+{
+    if (tryTakeToken()) {
+        return MaxConcurrentPermit{};
+    }
+
+    const clock::time_point start = clock::now();
+    const clock::time_point deadline = start + d_maxWaitTime;
+    const clock::time_point endOfSpin = start + std::min(d_spinTime, d_maxWaitTime);
+    // Reading the clock costs more than a spin: only check it once in a while.
+    // Without a spin budget block right away.
+    constexpr unsigned SpinsBetweenClockReads = 64;
+    for (unsigned spins = 1; endOfSpin > start; spins++) {
+        if (d_remainingTokens.value().load(std::memory_order_relaxed) > 0 and tryTakeToken()) {
+            return MaxConcurrentPermit{};
+        }
+        if (spins % SpinsBetweenClockReads == 0 and clock::now() >= endOfSpin) {
+            break;
+        }
+        detail::cpuRelax();
+    }
+
+    d_waiters.fetch_add(1, std::memory_order_seq_cst);
+    for (;;) {
+        if (tryTakeToken()) {
+            d_waiters.fetch_sub(1, std::memory_order_relaxed);
+            return MaxConcurrentPermit{};
+        }
+        const clock::time_point now = clock::now();
+        if (now >= deadline) {
+            d_waiters.fetch_sub(1, std::memory_order_relaxed);
+            return PermitAcquireTimeout{};
+        }
+        // Doesn't block if a token was released after we checked
+        d_remainingTokens.wait(0, deadline - now);
+    }
+}
+
+} // namespace resilient
@@ -0,0 +1,169 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+#include <thread>
+
+#include <resilient/common/variant.hpp>
+#include <resilient/policy/ratelimiter.hpp>
+
+namespace resilient {
+
+/// @brief A permit for an execution allowed by a token bucket.
+struct TokenBucketPermit
+{
+    // The token is consumed, nothing to give back
+};
+
+/**
+ * @brief Allow executions at a fixed rate, with bursts up to the size of a bucket of tokens.
+ * @related resilient::IRateLimiterStrategy
+ *
+ * The bucket holds at most `burst` tokens and is refilled with `tokens` tokens every `interval`.
+ * Each execution takes a token: if the bucket is empty the execution can wait for the next
+ * token, up to `maxWaitTime`. When the wait would be longer the strategy returns an error
+ * immediately, without waiting for the timeout.
+ *
+ * The bucket is refilled lazily from the time at which it would be full, which is the only
+ * state of the strategy: taking a token is a single CAS loop on it, so `acquire()` never takes
+ * a lock and never waits while tokens are available. A waiting execution reserves its token
+ * before sleeping, so the executions are allowed in the order they arrived.
+ *
+ * @tparam Clock The kind of clock to use when measuring time.
+ */
+template<typename Clock = std::chrono::steady_clock>
+class TokenBucketStrategy final
+: public INonBlockingRateLimiterStrategy<TokenBucketPermit, PermitAcquireTimeout>
+, public IWeightedRateLimiterStrategy<TokenBucketPermit, PermitAcquireTimeout>
+{
+public:
+    /**
+     * @brief Construct a new TokenBucketStrategy object, with a full bucket.
+     *
+     * @param tokens How many tokens are added to the bucket every `interval`.
+     * @param interval The interval over which `tokens` tokens are added.
+     * @param burst The size of the bucket: how many executions can happen at once after the
+     *              strategy was not used for a while.
+     * @param maxWaitTime How long an execution can wait for a token before returning an error.
+     * @param clock An instance of the clock to use to measure time. Defaults to a default initialized one.
+     * @throw std::invalid_argument If `tokens` or `burst` is 0.
+     */
+    TokenBucketStrategy(unsigned long tokens,
+                        std::chrono::microseconds interval,
+                        unsigned long burst,
+                        std::chrono::microseconds maxWaitTime,
+                        Clock clock = Clock());
+
+    Variant<TokenBucketPermit, PermitAcquireTimeout> acquire() override { return acquire(1); }
+
+    /// Take `weight` tokens at once. An execution weighing more than `burst` is never allowed,
+    /// as the bucket can't hold its tokens.
+    Variant<TokenBucketPermit, PermitAcquireTimeout> acquire(unsigned long weight) override;
+
+    /// Take a token only if the bucket is not empty, regardless of `maxWaitTime`.
+    Variant<TokenBucketPermit, PermitAcquireTimeout> tryAcquire() override
+    {
+        if (reserve(duration::zero(), 1) == duration::zero()) {
+            return TokenBucketPermit{};
+        }
+        return PermitAcquireTimeout{};
+    }
+
+    void release(TokenBucketPermit) override {}
+
+private:
+    using time_point = typename Clock::time_point;
+    using duration = typename Clock::duration;
+    using rep = typename duration::rep;
+
+    // Take `weight` tokens, which may be available only in the future, if they are available
+    // within `maxWait`. Return how long to wait for them, or a duration above `maxWait` if
+    // they are not taken.
+    duration reserve(duration maxWait, unsigned long weight);
+
+    static duration tokenInterval(unsigned long tokens, std::chrono::microseconds interval)
+    {
+        if (tokens == 0) {
+            throw std::invalid_argument("At least one token must be added every interval");
+        }
+        return std::chrono::duration_cast<duration>(interval) / static_cast<long>(tokens);
+    }
+
+    // How long it takes to add a token to the bucket
+    duration d_tokenInterval;
+    unsigned long d_burst;
+    // How long it takes to fill an empty bucket
+    duration d_bucketDuration;
+    duration d_maxWaitTime;
+    Clock d_clock;
+    // The time at which the bucket is full if no more tokens are taken.
+    // It's in the future when some of the tokens have been taken.
+    std::atomic<rep> d_fullAt;
+};
+
+template<typename Clock>
+TokenBucketStrategy<Clock>::TokenBucketStrategy(unsigned long tokens,
+                                                std::chrono::microseconds interval,
+                                                unsigned long burst,
+                                                std::chrono::microseconds maxWaitTime,
+                                                Clock clock)
+: d_tokenInterval(tokenInterval(tokens, interval))
+, d_burst(burst)
+, d_bucketDuration(d_tokenInterval * static_cast<long>(burst))
+, d_maxWaitTime(std::chrono::duration_cast<duration>(maxWaitTime))
+, d_clock(std::move(clock))
+, d_fullAt(d_clock.now().time_since_epoch().count())
+{
+    if (burst == 0) {
+        throw std::invalid_argument("The bucket must hold at least one token");
+    }
+}
+
+template<typename Clock>
+Variant<TokenBucketPermit, PermitAcquireTimeout>
+TokenBucketStrategy<Clock>::acquire(unsigned long weight)
+{
+    if (weight > d_burst) {
+        return PermitAcquireTimeout{};
+    }
+    const duration wait = reserve(d_maxWaitTime, weight);
+    if (wait > d_maxWaitTime) {
+        return PermitAcquireTimeout{};
+    }
+    if (wait > duration::zero()) {
+        std::this_thread::sleep_for(wait);
+    }
+    return TokenBucketPermit{};
+}
+
+template<typename Clock>
+typename TokenBucketStrategy<Clock>::duration
+TokenBucketStrategy<Clock>::reserve(duration maxWait, unsigned long weight)
+{
+    const duration increment = d_tokenInterval * static_cast<long>(weight);
+    const time_point now = d_clock.now();
+    rep current = d_fullAt.load(std::memory_order_relaxed);
+    for (;;) {
+        // A full bucket doesn't keep filling up
+        const time_point fullAt = std::max(time_point(duration(current)), now);
+        const time_point next = fullAt + increment;
+        // If the bucket would need more than `d_bucketDuration` to be full again we took
+        // tokens which are not there yet: we need to wait for it.
+        const time_point available = now + d_bucketDuration;
+        const duration wait = next > available ? next - available : duration::zero();
+        if (wait > maxWait) {
+            return wait;
+        }
+        if (d_fullAt.compare_exchange_weak(current,
+                                           next.time_since_epoch().count(),
+                                           std::memory_order_relaxed,
+                                           std::memory_order_relaxed))
+        {
+            return wait;
+        }
+    }
+}
+
+} // namespace resilient
@@ -0,0 +1,143 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <resilient/policy/retry/factory/constructstate.hpp>
+#include <resilient/policy/retry/types.hpp>
+
+namespace resilient {
+namespace retry {
+
+namespace detail {
+
+template<typename RetryState, typename = void>
+struct has_reset : std::false_type
+{
+};
+
+template<typename RetryState>
+struct has_reset<RetryState, decltype(std::declval<RetryState&>().reset(), void())>
+: std::true_type
+{
+};
+
+// The states returned to a factory and its copies, from any thread.
+template<typename RetryState>
+class FreeStates
+{
+public:
+    // Return nullptr if there is no free state
+    std::unique_ptr<RetryState> take()
+    {
+        std::lock_guard<std::mutex> guard{d_mutex};
+        if (d_states.empty()) {
+            return nullptr;
+        }
+        // The most recently returned state is the most likely to be in the cache
+        std::unique_ptr<RetryState> state = std::move(d_states.back());
+        d_states.pop_back();
+        return state;
+    }
+
+    // Destroy the state instead if there are already `maxStates` free states
+    void put(std::unique_ptr<RetryState> state, std::size_t maxStates)
+    {
+        std::lock_guard<std::mutex> guard{d_mutex};
+        if (d_states.size() < maxStates) {
+            d_states.push_back(std::move(state));
+        }
+    }
+
+private:
+    std::mutex d_mutex;
+    std::vector<std::unique_ptr<RetryState>> d_states;
+};
+
+} // namespace detail
+
+/**
+ * @brief A factory which reuses the RetryStates returned to it instead of constructing a new
+ *        one each time one is requested.
+ * @related resilient::Retry
+ *
+ * The returned states are kept in a free list of the factory, shared with its copies. A state
+ * taken from the list is reset: with its `reset()` member function if it has one, which must
+ * restore the state to how it was constructed and can keep the memory or the resources it owns,
+ * otherwise by assigning it a state constructed from the arguments, as `ConstructState` does.
+ *
+ * States can be returned from any thread: with `Retry::executeAsync()` they are returned from
+ * the thread of the scheduler, and reused by the threads starting the next executions. The
+ * list is protected by a mutex held only to take or put a pointer.
+ *
+ * The list keeps at most `MaxFreeStates` states: the states returned when it's full are
+ * destroyed. The free states are destroyed with the last copy of the factory.
+ *
+ * @note
+ * Implements the `RetryStateFactory` concept.
+ *
+ * @tparam RetryState The type of the RetryState constructed and returned.
+ * @tparam Args... The arguments to construct the retry state.
+ */
+template<typename RetryState, typename... Args>
+class PooledState
+{
+public:
+    static constexpr std::size_t MaxFreeStates = 16;
+
+    PooledState(Args... args)
+    : d_stateArguments(std::forward<Args>(args)...)
+    , d_freeStates(std::make_shared<detail::FreeStates<RetryState>>())
+    {
+    }
+
+    template<typename Failure>
+    RetryState& getRetryState(retriedtask_failure<Failure>)
+    {
+        if (std::unique_ptr<RetryState> state = d_freeStates->take()) {
+            reset(*state, detail::has_reset<RetryState>{});
+            return *state.release();
+        }
+        return *new RetryState(detail::construct_from_tuple<RetryState>(
+            d_stateArguments, std::make_index_sequence<sizeof...(Args)>{}));
+    }
+
+    void returnRetryState(RetryState& state)
+    {
+        d_freeStates->put(std::unique_ptr<RetryState>(&state), MaxFreeStates);
+    }
+
+private:
+    void reset(RetryState& state, std::true_type) { state.reset(); }
+
+    void reset(RetryState& state, std::false_type)
+    {
+        state = detail::construct_from_tuple<RetryState>(
+            d_stateArguments, std::make_index_sequence<sizeof...(Args)>{});
+    }
+
+    std::tuple<Args...> d_stateArguments;
+    // Copies share it, as they construct the same states
+    std::shared_ptr<detail::FreeStates<RetryState>> d_freeStates;
+};
+
+/**
+ * @brief Create an instance of PooledState with the given state and arguments.
+ *
+ * @tparam RetryState The state the factory will construct
+ * @param args The arguments to use to construct
+ * @return the factory
+ */
+template<typename RetryState, typename... Args>
+PooledState<RetryState, Args...> pooledstate(Args&&... args)
+{
+    return PooledState<RetryState, Args...>(std::forward<Args>(args)...);
+}
+
+} // namespace retry
+} // namespace resilient
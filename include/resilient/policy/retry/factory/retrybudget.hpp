@@ -0,0 +1,230 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include <resilient/common/variant.hpp>
+#include <resilient/policy/retry/types.hpp>
+
+namespace resilient {
+namespace retry {
+
+/**
+ * @brief Type returned when a `RetryBudget` doesn't allow to retry anymore.
+ * @related resilient::retry::RetryBudget
+ */
+struct RetryBudgetExhausted
+{
+};
+
+namespace detail {
+
+/**
+ * A budget of retries shared by many executions, as a lock-free count of tokens.
+ * Tokens are counted in thousandths, so that a success can deposit a fraction of a token.
+ * The deposit is rounded to the nearest thousandth, and must be at least one.
+ */
+class RetryTokens
+{
+public:
+    RetryTokens(double depositPerSuccess, unsigned long maxTokens)
+    : d_deposit(scaledDeposit(depositPerSuccess))
+    , d_max(static_cast<long long>(maxTokens) * Scale)
+    , d_balance(d_max)
+    {
+    }
+
+    // Take a token, if there is one.
+    bool withdraw()
+    {
+        long long balance = d_balance.load(std::memory_order_relaxed);
+        while (balance >= Scale) {
+            if (d_balance.compare_exchange_weak(
+                    balance, balance - Scale, std::memory_order_relaxed, std::memory_order_relaxed))
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void deposit()
+    {
+        long long balance = d_balance.load(std::memory_order_relaxed);
+        while (balance < d_max) {
+            if (d_balance.compare_exchange_weak(balance,
+                                                std::min(d_max, balance + d_deposit),
+                                                std::memory_order_relaxed,
+                                                std::memory_order_relaxed))
+            {
+                return;
+            }
+        }
+    }
+
+    double tokens() const
+    {
+        return static_cast<double>(d_balance.load(std::memory_order_relaxed)) / Scale;
+    }
+
+private:
+    static constexpr long long Scale = 1000;
+
+    static long long scaledDeposit(double depositPerSuccess)
+    {
+        // Written to also reject NaN
+        if (not(depositPerSuccess * Scale >= 1)) {
+            throw std::invalid_argument("A retry budget must deposit at least 0.001 tokens");
+        }
+        return std::llround(depositPerSuccess * Scale);
+    }
+
+    long long d_deposit;
+    long long d_max;
+    std::atomic<long long> d_balance;
+};
+
+} // namespace detail
+
+/**
+ * @brief A factory which limits the retries of all the executions to a fraction of the
+ *        successful executions.
+ * @related resilient::Retry
+ *
+ * When a dependency is down, every execution retrying multiplies the load on it by the number
+ * of retries. The budget is shared by all the executions using the factory (and its copies):
+ * each successful execution deposits `retryRatio` tokens, and each retry withdraws one. When
+ * the budget is empty the executions stop retrying, so the retries are at most about
+ * `retryRatio` of the successful executions, plus `maxTokens` for bursts. The budget starts full.
+ *
+ * The states are created by `RetryStateFactory` and decide when to retry and how long to wait;
+ * the budget only stops retries they allow. When a retry is stopped, `Retry` returns a `Variant`
+ * of the `stopretries_type` of the wrapped states and `RetryBudgetExhausted`.
+ *
+ * The budget is a single atomic counter: taking and depositing tokens never takes a lock.
+ *
+ * @note
+ * Implements the `RetryStateFactory` concept.
+ *
+ * @tparam RetryStateFactory The factory of the states deciding when to retry.
+ */
+template<typename RetryStateFactory>
+class RetryBudget
+{
+private:
+    template<typename Failure>
+    using inner_state_t = decltype(
+        std::declval<RetryStateFactory&>().getRetryState(retriedtask_failure<Failure>{}));
+
+public:
+    /**
+     * @brief The state which checks the budget before allowing the wrapped state to retry.
+     */
+    template<typename InnerState>
+    class State
+    {
+    public:
+        using stopretries_type =
+            Variant<typename std::remove_reference_t<InnerState>::stopretries_type,
+                    RetryBudgetExhausted>;
+
+        State(InnerState state, detail::RetryTokens& tokens)
+        : d_state(std::forward<InnerState>(state)), d_tokens(&tokens), d_failing(false)
+        {
+        }
+
+        Variant<retry_after, stopretries_type> shouldRetry()
+        {
+            auto decision = d_state.shouldRetry();
+            if (not holds_alternative<retry_after>(decision)) {
+                using inner_stop = typename std::remove_reference_t<InnerState>::stopretries_type;
+                return stopretries_type{get<inner_stop>(std::move(decision))};
+            }
+            if (not d_tokens->withdraw()) {
+                return stopretries_type{RetryBudgetExhausted{}};
+            }
+            // We don't know how the retry went until we are told it failed
+            d_failing = false;
+            return get<retry_after>(decision);
+        }
+
+        template<typename T>
+        void failedWith(T&& failure)
+        {
+            d_failing = true;
+            d_state.failedWith(std::forward<T>(failure));
+        }
+
+    private:
+        friend class RetryBudget;
+
+        InnerState d_state;
+        detail::RetryTokens* d_tokens;
+        // Whether the last execution failed
+        bool d_failing;
+    };
+
+    /**
+     * @brief Construct a new RetryBudget object, with a full budget.
+     *
+     * @param factory The factory of the states deciding when to retry.
+     * @param retryRatio How many tokens each successful execution deposits, for example 0.1 to
+     *                   allow 1 retry every 10 successful executions. The tokens are counted in
+     *                   thousandths: the ratio is rounded to the nearest 0.001, which is also the
+     *                   smallest ratio allowed.
+     * @param maxTokens The size of the budget: how many retries are allowed in a burst.
+     *
+     * @throw std::invalid_argument If `retryRatio` is smaller than 0.001.
+     */
+    RetryBudget(RetryStateFactory factory, double retryRatio, unsigned long maxTokens)
+    : d_factory(std::forward<RetryStateFactory>(factory))
+    , d_tokens(std::make_shared<detail::RetryTokens>(retryRatio, maxTokens))
+    {
+    }
+
+    template<typename Failure>
+    State<inner_state_t<Failure>> getRetryState(retriedtask_failure<Failure> failure)
+    {
+        return State<inner_state_t<Failure>>(d_factory.getRetryState(failure), *d_tokens);
+    }
+
+    template<typename InnerState>
+    void returnRetryState(State<InnerState> state)
+    {
+        if (not state.d_failing) {
+            d_tokens->deposit();
+        }
+        d_factory.returnRetryState(std::forward<InnerState>(state.d_state));
+    }
+
+    /**
+     * @brief How many retries the budget allows right now.
+     */
+    double tokens() const { return d_tokens->tokens(); }
+
+private:
+    RetryStateFactory d_factory;
+    std::shared_ptr<detail::RetryTokens> d_tokens;
+};
+
+/**
+ * @brief Create an instance of RetryBudget with the given factory.
+ * @related resilient::retry::RetryBudget
+ *
+ * @throw std::invalid_argument If `retryRatio` is smaller than 0.001.
+ */
+template<typename RetryStateFactory>
+RetryBudget<RetryStateFactory>
+retrybudget(RetryStateFactory&& factory, double retryRatio, unsigned long maxTokens)
+{
+    return RetryBudget<RetryStateFactory>(
+        std::forward<RetryStateFactory>(factory), retryRatio, maxTokens);
+}
+
+} // namespace retry
+} // namespace resilient
@@ -1,6 +1,12 @@
 #pragma once
 
+#include <chrono>
+#include <exception>
+#include <future>
+#include <memory>
+#include <stdexcept>
 #include <thread>
+#include <tuple>
 #include <type_traits>
 #include <utility>
 
@@ -70,6 +76,19 @@ namespace retry {
  * This call is done after all the retries for the given task have been executed.
  *
  *
+ * @par `Scheduler` concept
+ * A `Scheduler` runs functions after a delay, without blocking the caller. It is used by
+ * `executeAsync()` to wait between retries. `TimerWheel` implements it.
+ * The following must be valid for an instance named `scheduler` of type `T` which implements
+ * the `Scheduler` concept.
+ *
+ * @par
+ * - Scheduling a function
+ * Given `delay` of type `std::chrono::microseconds` and a callable `f` taking no arguments,
+ * `scheduler.schedule(delay, std::move(f));` must be valid, and must call `f` once at least
+ * `delay` later, on any thread. It may be called concurrently from many threads.
+ *
+ *
  * @tparam RetryStateFactory The factory used to create the RetryState used while
  */
 template<typename RetryStateFactory>
@@ -184,7 +203,133 @@ public:
         return get<stopretries_type>(std::forward<decltype(shouldRetry)>(shouldRetry));
     }
 
+    /**
+     * @brief Execute the task, retrying if it returns a failure, without ever blocking
+     *        a thread to wait between retries.
+     *
+     * The first execution happens right away in the calling thread. If it fails and the retry
+     * state allows to retry, the next execution is scheduled on the scheduler after the delay
+     * the state returned, and so on: no thread sleeps while waiting to retry.
+     *
+     * The callable and the arguments are copied (or moved), as they are used after this call
+     * returns. The retry state is used from the threads of the scheduler, and it's returned to
+     * the factory from one of them: the factory must allow it. The `Retry` and the scheduler
+     * must outlive the execution.
+     *
+     * @param scheduler The scheduler used to wait between retries. Must implement the
+     *                  `Scheduler` concept.
+     * @param callable The task to execute
+     * @param args... The arguments to the task
+     * @return A future which becomes ready with the result `execute()` would return, or with
+     *         the exception the task threw. If the scheduler destroys a scheduled retry without
+     *         running it the retry state is returned and the future holds a
+     *         `std::runtime_error`.
+     */
+    template<typename Scheduler, typename Callable, typename... Args>
+    std::future<return_type_t<std::decay_t<Callable>, std::decay_t<Args>...>>
+    executeAsync(Scheduler& scheduler, Callable&& callable, Args&&... args)
+    {
+        using execution_type =
+            AsyncExecution<Scheduler, std::decay_t<Callable>, std::decay_t<Args>...>;
+
+        auto execution = std::make_shared<execution_type>(d_retryStateFactory,
+                                                          scheduler,
+                                                          std::forward<Callable>(callable),
+                                                          std::forward<Args>(args)...);
+        auto future = execution->d_promise.get_future();
+        execution->attempt();
+        return future;
+    }
+
 private:
+    // The state of an execution of `executeAsync()`. It's kept alive by the scheduled retries.
+    template<typename Scheduler, typename Callable, typename... Args>
+    struct AsyncExecution
+    : public std::enable_shared_from_this<AsyncExecution<Scheduler, Callable, Args...>>
+    {
+        using failure_type = failure_type_of_returned_failable<Callable, Args...>;
+        using retry_state = Retry::retry_state<failure_type>;
+        using stopretries_type = Retry::stopretries_type<failure_type>;
+        using result_type = return_type_t<Callable, Args...>;
+
+        template<typename C, typename... A>
+        AsyncExecution(RetryStateFactory& factory, Scheduler& scheduler, C&& callable, A&&... args)
+        : d_factory(factory)
+        , d_scheduler(scheduler)
+        , d_callable(std::forward<C>(callable))
+        , d_args(std::forward<A>(args)...)
+        , d_state(factory.getRetryState(retriedtask_failure<failure_type>{}))
+        , d_stateReturned(false)
+        {
+        }
+
+        // Only reached without a result if the scheduler dropped the scheduled retry
+        ~AsyncExecution()
+        {
+            if (not d_stateReturned) {
+                returnState();
+                d_promise.set_exception(std::make_exception_ptr(
+                    std::runtime_error("The scheduler dropped the retry without running it")));
+            }
+        }
+
+        void attempt()
+        {
+            try {
+                // Can be called several times, so we can't move the callable and the arguments
+                decltype(auto) result{invokeWithArgs(std::index_sequence_for<Args...>{})};
+                if (holds_value(result)) {
+                    finish(result_type(get_value(std::forward<decltype(result)>(result))));
+                    return;
+                }
+                d_state.failedWith(get_failure(std::forward<decltype(result)>(result)));
+
+                decltype(auto) shouldRetry = d_state.shouldRetry();
+                if (holds_alternative<retry_after>(shouldRetry)) {
+                    auto self = this->shared_from_this();
+                    d_scheduler.schedule(get<retry_after>(shouldRetry).value,
+                                         [self]() { self->attempt(); });
+                    return;
+                }
+                finish(result_type(
+                    get<stopretries_type>(std::forward<decltype(shouldRetry)>(shouldRetry))));
+            }
+            catch (...)
+            {
+                returnState();
+                d_promise.set_exception(std::current_exception());
+            }
+        }
+
+        template<std::size_t... I>
+        decltype(auto) invokeWithArgs(std::index_sequence<I...>)
+        {
+            return resilient::detail::invoke(d_callable, std::get<I>(d_args)...);
+        }
+
+        void returnState()
+        {
+            if (not d_stateReturned) {
+                d_stateReturned = true;
+                d_factory.returnRetryState(std::forward<retry_state>(d_state));
+            }
+        }
+
+        void finish(result_type result)
+        {
+            returnState();
+            d_promise.set_value(std::move(result));
+        }
+
+        RetryStateFactory& d_factory;
+        Scheduler& d_scheduler;
+        Callable d_callable;
+        std::tuple<Args...> d_args;
+        retry_state d_state;
+        bool d_stateReturned;
+        std::promise<result_type> d_promise;
+    };
+
     RetryStateFactory d_retryStateFactory;
 };
 
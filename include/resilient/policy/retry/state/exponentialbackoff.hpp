@@ -0,0 +1,198 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <limits>
+#include <random>
+
+#include <resilient/common/variant.hpp>
+#include <resilient/policy/retry/state/retries.hpp>
+#include <resilient/policy/retry/types.hpp>
+
+namespace resilient {
+namespace retry {
+
+namespace detail {
+
+// Cheap to use, and seeded once per thread: each retry state doesn't need its own.
+inline std::minstd_rand& jitterEngine()
+{
+    thread_local std::minstd_rand engine{std::random_device{}()};
+    return engine;
+}
+
+inline std::chrono::microseconds uniformBetween(std::chrono::microseconds low,
+                                                std::chrono::microseconds high,
+                                                std::minstd_rand& engine)
+{
+    using rep = std::chrono::microseconds::rep;
+    return std::chrono::microseconds(
+        std::uniform_int_distribution<rep>(low.count(), std::max(low, high).count())(engine));
+}
+
+} // namespace detail
+
+/**
+ * @brief Wait exactly the exponential backoff.
+ * @related resilient::retry::ExponentialBackoff
+ *
+ * Tasks which failed together retry together: use it only when few tasks retry at the same time.
+ */
+struct NoJitter
+{
+    std::chrono::microseconds operator()(std::chrono::microseconds backoff,
+                                         std::chrono::microseconds /* previousDelay */,
+                                         std::chrono::microseconds /* initialDelay */,
+                                         std::chrono::microseconds /* maxDelay */,
+                                         std::minstd_rand& /* engine */) const
+    {
+        return backoff;
+    }
+};
+
+/**
+ * @brief Wait a random time between zero and the exponential backoff.
+ * @related resilient::retry::ExponentialBackoff
+ *
+ * Spreads the retries the most, at the cost of sometimes retrying right away.
+ */
+struct FullJitter
+{
+    std::chrono::microseconds operator()(std::chrono::microseconds backoff,
+                                         std::chrono::microseconds /* previousDelay */,
+                                         std::chrono::microseconds /* initialDelay */,
+                                         std::chrono::microseconds /* maxDelay */,
+                                         std::minstd_rand& engine) const
+    {
+        return detail::uniformBetween(std::chrono::microseconds(0), backoff, engine);
+    }
+};
+
+/**
+ * @brief Wait half of the exponential backoff, plus a random time up to the other half.
+ * @related resilient::retry::ExponentialBackoff
+ *
+ * Always waits at least half of the backoff, spreading the retries less than `FullJitter`.
+ */
+struct EqualJitter
+{
+    std::chrono::microseconds operator()(std::chrono::microseconds backoff,
+                                         std::chrono::microseconds /* previousDelay */,
+                                         std::chrono::microseconds /* initialDelay */,
+                                         std::chrono::microseconds /* maxDelay */,
+                                         std::minstd_rand& engine) const
+    {
+        const std::chrono::microseconds half = backoff / 2;
+        return half + detail::uniformBetween(std::chrono::microseconds(0), backoff - half, engine);
+    }
+};
+
+/**
+ * @brief Wait a random time between the initial delay and three times the previous delay.
+ * @related resilient::retry::ExponentialBackoff
+ *
+ * The delay grows from the previous random delay instead of from the number of retries, which
+ * decorrelates the retries of tasks which failed together.
+ */
+struct DecorrelatedJitter
+{
+    std::chrono::microseconds operator()(std::chrono::microseconds /* backoff */,
+                                         std::chrono::microseconds previousDelay,
+                                         std::chrono::microseconds initialDelay,
+                                         std::chrono::microseconds maxDelay,
+                                         std::minstd_rand& engine) const
+    {
+        const std::chrono::microseconds high =
+            previousDelay > maxDelay / 3 ? maxDelay : previousDelay * 3;
+        return std::min(maxDelay, detail::uniformBetween(initialDelay, high, engine));
+    }
+};
+
+/**
+ * @brief State to retry waiting exponentially longer between retries, with a random jitter.
+ * @related resilient::Retry
+ *
+ * The backoff before the n-th retry is `initialDelay * 2^(n-1)`, up to `maxDelay`.
+ * `Jitter` randomizes it, so that the tasks which failed at the same time, for example because
+ * a dependency was overloaded, don't retry all at the same time and overload it again.
+ * `NoJitter`, `FullJitter`, `EqualJitter` and `DecorrelatedJitter` are available.
+ *
+ * Failures returned by the executed function are ignored.
+ *
+ * @note
+ * Implements the `RetryState` concept.
+ *
+ * @tparam Jitter How to randomize the backoff.
+ */
+template<typename Jitter = FullJitter>
+class ExponentialBackoff
+{
+public:
+    using stopretries_type = NoMoreRetriesLeft;
+
+    /**
+     * @brief Construct a new ExponentialBackoff object.
+     *
+     * @param initialDelay The backoff before the first retry.
+     * @param maxDelay The longest backoff.
+     * @param maxRetries How many times to retry at most. Defaults to no limit.
+     * @param jitter How to randomize the backoff.
+     */
+    ExponentialBackoff(std::chrono::microseconds initialDelay,
+                       std::chrono::microseconds maxDelay,
+                       unsigned int maxRetries = std::numeric_limits<unsigned int>::max(),
+                       Jitter jitter = Jitter())
+    : d_initialDelay(initialDelay)
+    , d_maxDelay(std::max(initialDelay, maxDelay))
+    , d_backoff(d_initialDelay)
+    , d_previousDelay(d_initialDelay)
+    , d_maxRetries(maxRetries)
+    , d_retriesLeft(maxRetries)
+    , d_jitter(std::move(jitter))
+    {
+    }
+
+    Variant<retry_after, stopretries_type> shouldRetry()
+    {
+        if (d_retriesLeft == 0) {
+            return NoMoreRetriesLeft();
+        }
+        if (d_retriesLeft != std::numeric_limits<unsigned int>::max()) {
+            d_retriesLeft--;
+        }
+
+        d_previousDelay = d_jitter(
+            d_backoff, d_previousDelay, d_initialDelay, d_maxDelay, detail::jitterEngine());
+        // Double without overflowing
+        d_backoff = d_backoff > d_maxDelay / 2 ? d_maxDelay : d_backoff * 2;
+        return retry_after{d_previousDelay};
+    }
+
+    template<typename T>
+    void failedWith(T)
+    {
+    }
+
+    /**
+     * @brief Start again from the initial backoff, with all the retries, as when constructed.
+     */
+    void reset()
+    {
+        d_backoff = d_initialDelay;
+        d_previousDelay = d_initialDelay;
+        d_retriesLeft = d_maxRetries;
+    }
+
+private:
+    std::chrono::microseconds d_initialDelay;
+    std::chrono::microseconds d_maxDelay;
+    // The backoff before the next retry, before applying the jitter
+    std::chrono::microseconds d_backoff;
+    std::chrono::microseconds d_previousDelay;
+    unsigned int d_maxRetries;
+    unsigned int d_retriesLeft;
+    Jitter d_jitter;
+};
+
+} // namespace retry
+} // namespace resilient
@@ -36,7 +36,10 @@ public:
      *
      * @param numberOfRetries The number of retries
      */
-    Retries(unsigned int numberOfRetries) : d_retriesLeft(numberOfRetries) {}
+    Retries(unsigned int numberOfRetries)
+    : d_numberOfRetries(numberOfRetries), d_retriesLeft(numberOfRetries)
+    {
+    }
 
     Variant<retry_after, stopretries_type> shouldRetry()
     {
@@ -55,7 +58,13 @@ public:
     {
     }
 
+    /**
+     * @brief Allow again all the retries, as when constructed.
+     */
+    void reset() { d_retriesLeft = d_numberOfRetries; }
+
 private:
+    unsigned int d_numberOfRetries;
     unsigned int d_retriesLeft;
 };
 
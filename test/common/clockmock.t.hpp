@@ -0,0 +1,39 @@
+#pragma once
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstdint>
+#include <ratio>
+
+namespace resilient {
+namespace test {
+
+struct ClockMockState;
+using StrictClockMockState = ::testing::StrictMock<ClockMockState>;
+
+// A clock which returns the time the test decides.
+struct ClockMock
+{
+    typedef uint64_t rep;
+    typedef std::ratio<1l, 1000000000l> period;
+    typedef std::chrono::duration<rep, period> duration;
+    typedef std::chrono::time_point<ClockMock> time_point;
+
+    ClockMock(StrictClockMockState* state) : d_state(state) {}
+
+    time_point now();
+
+    StrictClockMockState* d_state;
+};
+
+struct ClockMockState
+{
+    MOCK_CONST_METHOD0(now, ClockMock::time_point());
+};
+
+inline ClockMock::time_point ClockMock::now() { return d_state->now(); }
+
+} // namespace test
+} // namespace resilient
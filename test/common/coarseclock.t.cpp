@@ -0,0 +1,54 @@
+#include <gtest/gtest.h>
+
+#include <resilient/common/coarseclock.hpp>
+#include <resilient/policy/circuitbreakerstrategy/countstrategy.hpp>
+
+#include <chrono>
+#include <thread>
+
+using namespace resilient;
+using namespace std::chrono_literals;
+
+namespace {
+
+template<typename Clock>
+struct CoarseClock_F : ::testing::Test
+{
+};
+
+using Clocks = ::testing::Types<CoarseClock, MonotonicCoarseClock>;
+
+} // namespace
+
+TYPED_TEST_CASE(CoarseClock_F, Clocks);
+
+TYPED_TEST(CoarseClock_F, When_TimePasses_Then_TheClockAdvances)
+{
+    TypeParam clock;
+    auto start = clock.now();
+    std::this_thread::sleep_for(50ms);
+    auto end = clock.now();
+    EXPECT_GT(end, start);
+    EXPECT_LE(end - start, 1s);
+}
+
+TYPED_TEST(CoarseClock_F, When_UsedByAStrategy_Then_ItMeasuresTheTrip)
+{
+    CountStrategy<TypeParam> strategy(1, 1s, 50ms, 1);
+    strategy.registerFailure();
+    EXPECT_FALSE(strategy.allowCall());
+    std::this_thread::sleep_for(100ms);
+    EXPECT_TRUE(strategy.allowCall());
+}
+
+TEST(CoarseClockTicker, When_ReadingTheTime_Then_ItIsCloseToSteadyClock)
+{
+    CoarseClockTicker ticker(1ms);
+    CoarseClock clock(ticker);
+    std::this_thread::sleep_for(10ms);
+    auto error =
+        std::chrono::steady_clock::now().time_since_epoch() - clock.now().time_since_epoch();
+    EXPECT_GE(error, 0ns);
+    EXPECT_LT(error, 100ms);
+    EXPECT_EQ(ticker.resolution(), 1ms);
+}
@@ -0,0 +1,230 @@
+#include <gtest/gtest.h>
+
+#include <resilient/common/timerwheel.hpp>
+#include <resilient/detail/timerwheel.hpp>
+#include <resilient/policy/retry/factory/constructstate.hpp>
+#include <resilient/policy/retry/retry.hpp>
+#include <resilient/policy/retry/state/exponentialbackoff.hpp>
+#include <resilient/task/failable.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <thread>
+#include <vector>
+
+using namespace resilient;
+using namespace std::chrono_literals;
+
+namespace {
+
+std::function<void()> record(std::vector<int>& fired, int id)
+{
+    return [&fired, id]() { fired.push_back(id); };
+}
+
+void advance(detail::HierarchicalTimerWheel& wheel, std::uint64_t tick)
+{
+    std::vector<std::function<void()>> expired;
+    wheel.advance(tick, expired);
+    for (auto& function : expired) {
+        function();
+    }
+}
+
+struct Failure
+{
+};
+
+} // namespace
+
+TEST(HierarchicalTimerWheel, When_TheExpiryIsReached_Then_TheTimerExpires)
+{
+    std::vector<int> fired;
+    detail::HierarchicalTimerWheel wheel;
+    wheel.insert(5, record(fired, 1));
+    EXPECT_EQ(wheel.size(), 1u);
+
+    advance(wheel, 4);
+    EXPECT_TRUE(fired.empty());
+    advance(wheel, 5);
+    EXPECT_EQ(fired, std::vector<int>{1});
+    EXPECT_TRUE(wheel.empty());
+    EXPECT_EQ(wheel.now(), 5u);
+}
+
+TEST(HierarchicalTimerWheel, When_TheTimersAreInHigherLevels_Then_TheyExpireAtTheirTick)
+{
+    const std::vector<std::uint64_t> expiries{255, 256, 300, 65535, 65536, 70000, 1u << 20};
+    std::vector<int> fired;
+    detail::HierarchicalTimerWheel wheel;
+    advance(wheel, 10);
+    for (std::size_t i = 0; i < expiries.size(); i++) {
+        wheel.insert(expiries[i], record(fired, static_cast<int>(i)));
+    }
+
+    for (std::size_t i = 0; i < expiries.size(); i++) {
+        advance(wheel, expiries[i] - 1);
+        EXPECT_EQ(fired.size(), i) << "expiry " << expiries[i];
+        advance(wheel, expiries[i]);
+        ASSERT_EQ(fired.size(), i + 1) << "expiry " << expiries[i];
+        EXPECT_EQ(fired.back(), static_cast<int>(i));
+    }
+    EXPECT_TRUE(wheel.empty());
+}
+
+TEST(HierarchicalTimerWheel, When_AdvancingManyTicks_Then_TheEarlierTimersComeFirst)
+{
+    std::vector<int> fired;
+    detail::HierarchicalTimerWheel wheel;
+    wheel.insert(1000, record(fired, 3));
+    wheel.insert(20, record(fired, 2));
+    wheel.insert(3, record(fired, 1));
+
+    advance(wheel, 2000);
+    EXPECT_EQ(fired, (std::vector<int>{1, 2, 3}));
+}
+
+TEST(HierarchicalTimerWheel, When_TheExpiryIsPast_Then_TheTimerExpiresAtTheNextTick)
+{
+    std::vector<int> fired;
+    detail::HierarchicalTimerWheel wheel;
+    advance(wheel, 100);
+    wheel.insert(50, record(fired, 1));
+
+    advance(wheel, 101);
+    EXPECT_EQ(fired, std::vector<int>{1});
+}
+
+TEST(HierarchicalTimerWheel, When_ATimerIsCancelled_Then_ItDoesNotExpire)
+{
+    std::vector<int> fired;
+    detail::HierarchicalTimerWheel wheel;
+    detail::TimerNode& first = wheel.insert(300, record(fired, 1));
+    const std::uint64_t generation = first.d_generation;
+    wheel.insert(300, record(fired, 2));
+
+    EXPECT_TRUE(wheel.cancel(first, generation));
+    EXPECT_FALSE(wheel.cancel(first, generation));
+    EXPECT_EQ(wheel.size(), 1u);
+
+    // The node is reused, but the old handle doesn't cancel the new timer
+    detail::TimerNode& third = wheel.insert(300, record(fired, 3));
+    EXPECT_EQ(&third, &first);
+    EXPECT_FALSE(wheel.cancel(first, generation));
+
+    advance(wheel, 300);
+    EXPECT_EQ(fired.size(), 2u);
+    EXPECT_EQ(std::count(fired.begin(), fired.end(), 1), 0);
+}
+
+TEST(HierarchicalTimerWheel, When_LookingForTheNextEvent_Then_TheEmptySlotsAreSkipped)
+{
+    std::vector<int> fired;
+    detail::HierarchicalTimerWheel wheel;
+    advance(wheel, 10);
+    // Nothing to do before the lowest level wraps around
+    EXPECT_EQ(wheel.nextEvent(), 256u);
+
+    wheel.insert(1000, record(fired, 1));
+    EXPECT_EQ(wheel.nextEvent(), 256u);
+    wheel.insert(50, record(fired, 2));
+    EXPECT_EQ(wheel.nextEvent(), 50u);
+
+    advance(wheel, 50);
+    EXPECT_EQ(fired, std::vector<int>{2});
+    EXPECT_EQ(wheel.nextEvent(), 256u);
+
+    // After the wrap around the timer moved down is found
+    advance(wheel, 999);
+    EXPECT_EQ(wheel.nextEvent(), 1000u);
+}
+
+TEST(TimerWheel, When_ATimerIsScheduled_Then_ItRunsAfterTheDelay)
+{
+    TimerWheel wheel(1ms);
+    EXPECT_EQ(wheel.tick(), 1ms);
+
+    std::promise<std::chrono::steady_clock::time_point> ran;
+    const auto start = std::chrono::steady_clock::now();
+    wheel.schedule(20ms, [&ran]() { ran.set_value(std::chrono::steady_clock::now()); });
+
+    auto future = ran.get_future();
+    ASSERT_EQ(future.wait_for(5s), std::future_status::ready);
+    EXPECT_GE(future.get() - start, 20ms);
+    EXPECT_EQ(wheel.size(), 0u);
+}
+
+TEST(TimerWheel, When_ATimerIsCancelled_Then_ItDoesNotRun)
+{
+    TimerWheel wheel(1ms);
+    std::promise<int> ran;
+    TimerHandle cancelled = wheel.schedule(10ms, [&ran]() { ran.set_value(1); });
+    wheel.schedule(30ms, [&ran]() { ran.set_value(2); });
+
+    EXPECT_TRUE(wheel.cancel(cancelled));
+    EXPECT_FALSE(wheel.cancel(cancelled));
+    EXPECT_FALSE(wheel.cancel(TimerHandle()));
+
+    auto future = ran.get_future();
+    ASSERT_EQ(future.wait_for(5s), std::future_status::ready);
+    EXPECT_EQ(future.get(), 2);
+}
+
+TEST(TimerWheel, When_UsedByRetry_Then_TheRetriesAreScheduledOnTheWheel)
+{
+    TimerWheel wheel(1ms);
+    auto retry = retry::retry(
+        retry::constructstate<retry::ExponentialBackoff<retry::NoJitter>>(5ms, 5ms, 5u));
+
+    int calls = 0;
+    const auto start = std::chrono::steady_clock::now();
+    auto future = retry.executeAsync(wheel, [&calls]() {
+        calls++;
+        return calls < 3 ? Failable<int, Failure>(Failure()) : Failable<int, Failure>(calls);
+    });
+
+    ASSERT_EQ(future.wait_for(5s), std::future_status::ready);
+    auto result = future.get();
+    ASSERT_TRUE(holds_value(result));
+    EXPECT_EQ(get_value(result), 3);
+    EXPECT_GE(std::chrono::steady_clock::now() - start, 10ms);
+}
+
+TEST(TimerWheel, When_ThreadsScheduleAndCancelConcurrently_Then_OnlyTheOthersRun)
+{
+    TimerWheel wheel(1ms);
+    std::atomic<int> ran{0};
+    std::atomic<int> cancelled{0};
+    constexpr int Threads = 4;
+    constexpr int TimersPerThread = 200;
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < Threads; t++) {
+        threads.emplace_back([&wheel, &ran, &cancelled]() {
+            for (int i = 0; i < TimersPerThread; i++) {
+                const auto delay = std::chrono::milliseconds(i % 7);
+                TimerHandle handle = wheel.schedule(delay, [&ran]() { ran++; });
+                // Some are cancelled before they run, some too late
+                if (i % 2 == 0 and wheel.cancel(handle)) {
+                    cancelled++;
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    const auto deadline = std::chrono::steady_clock::now() + 5s;
+    while (ran + cancelled < Threads * TimersPerThread
+           and std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(1ms);
+    }
+    EXPECT_EQ(ran + cancelled, Threads * TimersPerThread);
+    EXPECT_GT(cancelled, 0);
+    EXPECT_EQ(wheel.size(), 0u);
+}
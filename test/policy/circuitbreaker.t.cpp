@@ -2,10 +2,19 @@
 #include <gtest/gtest.h>
 
 #include <resilient/policy/circuitbreaker.hpp>
+#include <resilient/policy/circuitbreakerstrategy/countstrategy.hpp>
+#include <resilient/policy/circuitbreakerstrategy/lockfreecountstrategy.hpp>
+#include <resilient/policy/circuitbreakerstrategy/statechange.hpp>
 #include <test/policy/policy_common.t.hpp>
 
+#include <chrono>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+
 using namespace policy_test;
 using namespace resilient;
+using namespace std::chrono_literals;
 
 namespace {
 
@@ -45,4 +54,100 @@ TEST_F(MultiPolicies, CircuitbreakerOpenReturnsError)
     auto result = cb.execute(d_callable);
     EXPECT_TRUE(holds_failure(result));
     EXPECT_TRUE(holds_alternative<CircuitbreakerIsOpen>(get_failure(result)));
-}
\ No newline at end of file
+}
+
+namespace {
+
+struct TimedCircuitbreakerStrategyMock : CircuitbreakerStrategyMock
+{
+    bool needsCallDuration() const override { return true; }
+
+    MOCK_METHOD1(registerTimedFailure, void(std::chrono::nanoseconds));
+    MOCK_METHOD1(registerTimedSuccess, void(std::chrono::nanoseconds));
+};
+
+} // namespace
+
+TEST_F(SinglePolicies, When_StrategyNeedsCallDuration_Then_TimedMethodsAreCalled)
+{
+    std::unique_ptr<TimedCircuitbreakerStrategyMock> strategy{
+        new testing::StrictMock<TimedCircuitbreakerStrategyMock>()};
+
+    EXPECT_CALL(d_callable, call()).WillOnce(::testing::Return(SingleFailureFailable(1)));
+    EXPECT_CALL(*strategy, allowCall()).WillOnce(testing::Return(true));
+    EXPECT_CALL(*strategy, registerTimedSuccess(testing::Ge(std::chrono::nanoseconds::zero())))
+        .Times(1);
+
+    Circuitbreaker cb(std::move(strategy));
+    auto result = cb.execute(d_callable);
+    EXPECT_TRUE(holds_value(result));
+}
+
+TEST_F(SinglePolicies, When_StrategyIsConcrete_Then_ItIsCalledDirectly)
+{
+    std::unique_ptr<CircuitbreakerStrategyMock> strategy{
+        new testing::StrictMock<CircuitbreakerStrategyMock>()};
+
+    EXPECT_CALL(d_callable, call()).WillOnce(::testing::Return(SingleFailureFailable(1)));
+    EXPECT_CALL(*strategy, allowCall()).WillOnce(testing::Return(true));
+    EXPECT_CALL(*strategy, registerSuccess()).Times(1);
+
+    BasicCircuitbreaker<CircuitbreakerStrategyMock> cb(std::move(strategy));
+    auto result = cb.execute(d_callable);
+    EXPECT_TRUE(holds_value(result));
+    EXPECT_EQ(get_value(result), 1);
+}
+
+TEST(Circuitbreaker, When_TheTaskThrows_Then_AFailureIsRegistered)
+{
+    std::unique_ptr<CircuitbreakerStrategyMock> strategy{
+        new testing::StrictMock<CircuitbreakerStrategyMock>()};
+
+    EXPECT_CALL(*strategy, allowCall()).WillOnce(testing::Return(true));
+    EXPECT_CALL(*strategy, registerFailure()).Times(1);
+
+    Circuitbreaker cb(std::move(strategy));
+    EXPECT_THROW(cb.execute([]() -> SingleFailureFailable { throw std::runtime_error("error"); }),
+                 std::runtime_error);
+}
+
+namespace {
+
+template<typename Strategy>
+struct CircuitbreakerProbes_F : ::testing::Test
+{
+};
+
+using ProbingStrategies = ::testing::Types<CountStrategy<>, LockFreeCountStrategy<>>;
+
+} // namespace
+
+TYPED_TEST_CASE(CircuitbreakerProbes_F, ProbingStrategies);
+
+TYPED_TEST(CircuitbreakerProbes_F, When_AProbeThrows_Then_ItTripsAndReleasesItsSlot)
+{
+    auto queue = std::make_shared<StateChangeQueue>(8);
+    std::unique_ptr<TypeParam> strategy{new TypeParam(1, 60s, 1ms, 1, 1)};
+    strategy->notifyStateChangesTo(queue);
+    BasicCircuitbreaker<TypeParam> cb(std::move(strategy));
+    auto fail = []() { return SingleFailureFailable(Failure()); };
+    auto throwing = []() -> SingleFailureFailable { throw std::runtime_error("error"); };
+
+    EXPECT_TRUE(holds_alternative<Failure>(get_failure(cb.execute(fail))));
+    std::this_thread::sleep_for(2ms);
+    // The only probe throws
+    EXPECT_THROW(cb.execute(throwing), std::runtime_error);
+
+    CircuitbreakerStateChange change;
+    ASSERT_TRUE(queue->pop(change));
+    EXPECT_EQ(change.to, CircuitbreakerState::Open);
+    ASSERT_TRUE(queue->pop(change));
+    EXPECT_EQ(change.to, CircuitbreakerState::HalfOpen);
+    ASSERT_TRUE(queue->pop(change));
+    EXPECT_EQ(change.from, CircuitbreakerState::HalfOpen);
+    EXPECT_EQ(change.to, CircuitbreakerState::Open);
+
+    // Once the trip is over a new probe is allowed
+    std::this_thread::sleep_for(2ms);
+    EXPECT_TRUE(holds_value(cb.execute([]() { return SingleFailureFailable(1); })));
+}
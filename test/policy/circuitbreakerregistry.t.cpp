@@ -0,0 +1,140 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <resilient/policy/circuitbreakerregistry.hpp>
+#include <resilient/policy/circuitbreakerstrategy/countstrategy.hpp>
+#include <test/common/clockmock.t.hpp>
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace resilient;
+using namespace std::chrono_literals;
+
+using resilient::test::ClockMock;
+using resilient::test::StrictClockMockState;
+
+namespace {
+
+struct CircuitbreakerRegistry_F : ::testing::Test
+{
+    using Registry = CircuitbreakerRegistry<std::string, CountStrategy<>, ClockMock>;
+
+    CircuitbreakerRegistry_F()
+    : d_clockState()
+    , d_created(0)
+    , d_registry(
+          [this](const std::string&) {
+              d_created++;
+              return std::unique_ptr<CountStrategy<>>(new CountStrategy<>(1, 1s, 1s, 1));
+          },
+          2,
+          10s,
+          1,
+          &d_clockState)
+    , d_currentTime(0)
+    {
+        EXPECT_CALL(d_clockState, now())
+            .WillRepeatedly(::testing::Invoke(this, &CircuitbreakerRegistry_F::testTime));
+    }
+
+    StrictClockMockState d_clockState;
+    unsigned int d_created;
+    Registry d_registry;
+
+    // Used to trace time in the tests
+    std::chrono::seconds d_currentTime;
+
+    ClockMock::time_point testTime() { return ClockMock::time_point(d_currentTime); }
+};
+
+} // namespace
+
+TEST_F(CircuitbreakerRegistry_F, When_TheSameKeyIsRequested_Then_TheSameCircuitbreakerIsReturned)
+{
+    auto first = d_registry.get("a");
+    auto second = d_registry.get("a");
+    EXPECT_EQ(first, second);
+    EXPECT_EQ(d_created, 1u);
+}
+
+TEST_F(CircuitbreakerRegistry_F, When_DifferentKeysAreRequested_Then_DifferentCircuitbreakers)
+{
+    EXPECT_NE(d_registry.get("a"), d_registry.get("b"));
+    EXPECT_EQ(d_created, 2u);
+    EXPECT_EQ(d_registry.size(), 2u);
+}
+
+TEST_F(CircuitbreakerRegistry_F, When_TheRegistryIsFull_Then_TheLeastRecentlyUsedIsEvicted)
+{
+    d_registry.get("a");
+    d_currentTime += 1s;
+    d_registry.get("b");
+    d_currentTime += 1s;
+    d_registry.get("a");
+    d_currentTime += 1s;
+    d_registry.get("c");
+
+    EXPECT_EQ(d_registry.size(), 2u);
+    EXPECT_EQ(d_created, 3u);
+    d_registry.get("a");
+    EXPECT_EQ(d_created, 3u);
+    d_registry.get("b");
+    EXPECT_EQ(d_created, 4u);
+}
+
+TEST_F(CircuitbreakerRegistry_F, When_CircuitbreakersAreIdle_Then_TheyAreEvicted)
+{
+    d_registry.get("a");
+    d_currentTime += 5s;
+    d_registry.get("b");
+    d_currentTime += 6s;
+
+    EXPECT_EQ(d_registry.evictIdle(), 1u);
+    EXPECT_EQ(d_registry.size(), 1u);
+    d_registry.get("b");
+    EXPECT_EQ(d_created, 2u);
+}
+
+TEST_F(CircuitbreakerRegistry_F, Given_ACircuitbreakerIsInUse_When_ItIsEvicted_Then_ItStaysValid)
+{
+    auto circuitbreaker = d_registry.get("a");
+    EXPECT_TRUE(d_registry.remove("a"));
+    EXPECT_FALSE(d_registry.remove("a"));
+
+    auto result = circuitbreaker->execute([]() { return Failable<int, std::string>(1); });
+    EXPECT_TRUE(holds_value(result));
+    EXPECT_NE(d_registry.get("a"), circuitbreaker);
+}
+
+TEST(CircuitbreakerRegistry, When_ManyThreadsRequestTheSameKeys_Then_TheyShareTheCircuitbreakers)
+{
+    CircuitbreakerRegistry<int> registry(
+        [](int) {
+            return std::unique_ptr<ICircuitbreakerStrategy>(new CountStrategy<>(1, 1s, 1s, 1));
+        },
+        1000,
+        10s);
+
+    const int keys = 64;
+    std::vector<std::vector<std::shared_ptr<Circuitbreaker>>> seen(4);
+    std::vector<std::thread> threads;
+    for (auto& circuitbreakers : seen) {
+        threads.emplace_back([&registry, &circuitbreakers]() {
+            for (int key = 0; key < keys; key++) {
+                circuitbreakers.push_back(registry.get(key));
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    EXPECT_EQ(registry.size(), static_cast<std::size_t>(keys));
+    for (auto& circuitbreakers : seen) {
+        EXPECT_EQ(circuitbreakers, seen.front());
+    }
+}
@@ -2,40 +2,21 @@
 #include <gtest/gtest.h>
 
 #include <resilient/policy/circuitbreakerstrategy/countstrategy.hpp>
+#include <test/common/clockmock.t.hpp>
 
 #include <chrono>
+#include <stdexcept>
+#include <thread>
 
 using namespace resilient;
 using namespace std::chrono_literals;
 using ::testing::Return;
 
-struct ClockMockState;
-using StrictClockMockState = ::testing::StrictMock<ClockMockState>;
-
-struct ClockMock
-{
-    typedef uint64_t rep;
-    typedef std::ratio<1l, 1000000000l> period;
-    typedef std::chrono::duration<rep, period> duration;
-    typedef std::chrono::time_point<ClockMock> time_point;
-
-    ClockMock(StrictClockMockState* state) : d_state(state) {}
-
-    time_point now();
-
-    StrictClockMockState* d_state;
-};
-
+using resilient::test::ClockMock;
+using resilient::test::StrictClockMockState;
 using time_point = ClockMock::time_point;
 using duration = ClockMock::duration;
 
-struct ClockMockState
-{
-    MOCK_CONST_METHOD0(now, time_point());
-};
-
-time_point ClockMock::now() { return d_state->now(); }
-
 StrictClockMockState* setStrategyCtorExpectations(StrictClockMockState* state)
 {
     EXPECT_CALL(*state, now()).WillOnce(Return(time_point(0s)));
@@ -133,4 +114,127 @@ TEST_F(CountStrategy_F, Given_IsShortcircuited_When_EnoughTimeIsPassed_Then_Allo
     triggerShortcircuit();
     advanceTime(d_tripDuration);
     EXPECT_TRUE(d_strategy.allowCall());
-}
\ No newline at end of file
+}
+
+namespace {
+
+struct CountStrategyProbes_F : ::testing::Test
+{
+    CountStrategyProbes_F()
+    : d_clockState()
+    , d_maxProbes(2)
+    , d_strategy(1,
+                 60s,
+                 30s,
+                 3,
+                 d_maxProbes,
+                 ClockMock(setStrategyCtorExpectations(&d_clockState)))
+    , d_currentTime(0)
+    {
+        EXPECT_CALL(d_clockState, now())
+            .WillRepeatedly(::testing::Invoke(this, &CountStrategyProbes_F::testTime));
+    }
+
+    StrictClockMockState d_clockState;
+    unsigned long d_maxProbes;
+    CountStrategy<ClockMock> d_strategy;
+    std::chrono::seconds d_currentTime;
+
+    time_point testTime() { return time_point(d_currentTime); }
+
+    void tripAndWait()
+    {
+        d_strategy.registerFailure();
+        EXPECT_FALSE(d_strategy.allowCall());
+        d_currentTime += 30s;
+    }
+};
+
+} // namespace
+
+TEST_F(CountStrategyProbes_F,
+       Given_IsTryingToLetThrough_When_ProbesAreRunning_Then_OthersAreNotAllowed)
+{
+    tripAndWait();
+    for (unsigned int i = 0; i < d_maxProbes; i++) {
+        EXPECT_TRUE(d_strategy.allowCall());
+    }
+    EXPECT_FALSE(d_strategy.allowCall());
+}
+
+TEST_F(CountStrategyProbes_F, Given_IsTryingToLetThrough_When_AProbeSucceeds_Then_AnotherIsAllowed)
+{
+    tripAndWait();
+    EXPECT_TRUE(d_strategy.allowCall());
+    EXPECT_TRUE(d_strategy.allowCall());
+    d_strategy.registerSuccess();
+    EXPECT_TRUE(d_strategy.allowCall());
+    EXPECT_FALSE(d_strategy.allowCall());
+}
+
+TEST_F(CountStrategyProbes_F, Given_IsTryingToLetThrough_When_ProbesRecover_Then_AllCallsAreAllowed)
+{
+    tripAndWait();
+    for (unsigned int i = 0; i < 3; i++) {
+        EXPECT_TRUE(d_strategy.allowCall());
+        d_strategy.registerSuccess();
+    }
+    for (unsigned int i = 0; i < d_maxProbes * 2; i++) {
+        EXPECT_TRUE(d_strategy.allowCall());
+    }
+}
+
+TEST_F(CountStrategyProbes_F, Given_IsTryingToLetThrough_When_AProbeFails_Then_TheProbesAreReleased)
+{
+    tripAndWait();
+    EXPECT_TRUE(d_strategy.allowCall());
+    EXPECT_TRUE(d_strategy.allowCall());
+    d_strategy.registerFailure();
+    EXPECT_FALSE(d_strategy.allowCall());
+    d_currentTime += 30s;
+    EXPECT_TRUE(d_strategy.allowCall());
+    EXPECT_TRUE(d_strategy.allowCall());
+}
+
+TEST_F(CountStrategyProbes_F,
+       Given_IsTryingToLetThrough_When_CallsAllowedBeforeTheTripEnd_Then_TheyAreIgnored)
+{
+    tripAndWait();
+    for (unsigned int i = 0; i < d_maxProbes; i++) {
+        EXPECT_TRUE(d_strategy.allowCall());
+    }
+    // Calls allowed before the trip end on another thread: they took no slot
+    std::thread([this]() {
+        for (int i = 0; i < 3; i++) {
+            d_strategy.registerSuccess();
+        }
+        d_strategy.registerFailure();
+    }).join();
+    // The slots of the probes are still taken, and it didn't recover nor trip
+    EXPECT_FALSE(d_strategy.allowCall());
+    d_strategy.registerSuccess();
+    EXPECT_TRUE(d_strategy.allowCall());
+}
+
+TEST_F(CountStrategyProbes_F,
+       Given_IsTryingToLetThrough_When_TheProbesAreLostForTheTripDuration_Then_ANewPeriodStarts)
+{
+    tripAndWait();
+    for (unsigned int i = 0; i < d_maxProbes; i++) {
+        EXPECT_TRUE(d_strategy.allowCall());
+    }
+    // The probes are never registered
+    d_currentTime += 29s;
+    EXPECT_FALSE(d_strategy.allowCall());
+    d_currentTime += 1s;
+    for (unsigned int i = 0; i < d_maxProbes; i++) {
+        EXPECT_TRUE(d_strategy.allowCall());
+    }
+    EXPECT_FALSE(d_strategy.allowCall());
+}
+
+TEST(CountStrategy, When_NoProbeIsAllowed_Then_TheConstructorThrows)
+{
+    EXPECT_THROW(CountStrategy<std::chrono::steady_clock>(1, 60s, 30s, 3, 0),
+                 std::invalid_argument);
+}
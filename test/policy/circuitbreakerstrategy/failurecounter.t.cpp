@@ -0,0 +1,70 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <resilient/policy/circuitbreakerstrategy/failurecounter.hpp>
+
+#include <thread>
+#include <vector>
+
+using namespace resilient;
+
+namespace {
+
+template<typename Counter>
+struct FailureCounter_F : ::testing::Test
+{
+    Counter d_counter;
+};
+
+using Counters =
+    ::testing::Types<SharedFailureCounter, ShardedFailureCounter<>, ShardedFailureCounter<1>>;
+
+} // namespace
+
+TYPED_TEST_CASE(FailureCounter_F, Counters);
+
+TYPED_TEST(FailureCounter_F, When_LessFailuresThanThreshold_Then_ThresholdIsNotReached)
+{
+    for (int i = 0; i < 9; i++) {
+        EXPECT_FALSE(this->d_counter.increment(10));
+    }
+    EXPECT_FALSE(this->d_counter.reached(10));
+}
+
+TYPED_TEST(FailureCounter_F, When_FailuresReachThreshold_Then_IncrementReturnsTrue)
+{
+    for (int i = 0; i < 9; i++) {
+        this->d_counter.increment(10);
+    }
+    EXPECT_TRUE(this->d_counter.increment(10));
+    EXPECT_TRUE(this->d_counter.reached(10));
+}
+
+TYPED_TEST(FailureCounter_F, When_Reset_Then_CountingStartsFromZero)
+{
+    for (int i = 0; i < 10; i++) {
+        this->d_counter.increment(10);
+    }
+    this->d_counter.reset();
+    EXPECT_FALSE(this->d_counter.reached(1));
+    EXPECT_TRUE(this->d_counter.increment(1));
+}
+
+TYPED_TEST(FailureCounter_F, When_ManyThreadsFail_Then_AllFailuresAreCounted)
+{
+    const unsigned long threshold = 4000;
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 4; i++) {
+        threads.emplace_back([this, threshold]() {
+            for (unsigned long j = 0; j < threshold / 4; j++) {
+                this->d_counter.increment(threshold);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    EXPECT_TRUE(this->d_counter.reached(threshold));
+    EXPECT_FALSE(this->d_counter.reached(threshold + 1));
+}
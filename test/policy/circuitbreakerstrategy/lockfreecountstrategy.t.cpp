@@ -0,0 +1,325 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <resilient/policy/circuitbreakerstrategy/lockfreecountstrategy.hpp>
+#include <test/common/clockmock.t.hpp>
+
+#include <chrono>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+using namespace resilient;
+using namespace std::chrono_literals;
+using ::testing::Return;
+
+using resilient::test::ClockMock;
+using resilient::test::StrictClockMockState;
+
+namespace {
+
+using time_point = ClockMock::time_point;
+
+StrictClockMockState* setStrategyCtorExpectations(StrictClockMockState* state)
+{
+    EXPECT_CALL(*state, now()).WillOnce(Return(time_point(0s)));
+    return state;
+}
+
+struct LockFreeCountStrategy_F : ::testing::Test
+{
+    LockFreeCountStrategy_F()
+    : d_clockState()
+    , d_failureThreshold(5)
+    , d_failureInterval(60)
+    , d_tripDuration(30)
+    , d_recoverSuccesses(2)
+    , d_strategy(d_failureThreshold,
+                 d_failureInterval,
+                 d_tripDuration,
+                 d_recoverSuccesses,
+                 ClockMock(setStrategyCtorExpectations(&d_clockState)))
+    , d_currentTime(0)
+    {
+        EXPECT_CALL(d_clockState, now())
+            .WillRepeatedly(::testing::Invoke(this, &LockFreeCountStrategy_F::testTime));
+    }
+
+    StrictClockMockState d_clockState;
+    unsigned long d_failureThreshold;
+    std::chrono::seconds d_failureInterval;
+    std::chrono::seconds d_tripDuration;
+    unsigned long d_recoverSuccesses;
+    LockFreeCountStrategy<ClockMock> d_strategy;
+
+    // Used to trace time in the tests
+    std::chrono::milliseconds d_currentTime;
+
+    time_point testTime() { return time_point(d_currentTime); }
+
+    void advanceTime(std::chrono::milliseconds delta = std::chrono::milliseconds(1))
+    {
+        d_currentTime += delta;
+    }
+
+    void triggerShortcircuit()
+    {
+        for (unsigned int i = 0; i < d_failureThreshold; i++) {
+            advanceTime();
+            d_strategy.registerFailure();
+        }
+    }
+};
+
+} // namespace
+
+TEST_F(LockFreeCountStrategy_F, Given_IsOpen_When_RequestsSucceed_Then_CallsAreAllowed)
+{
+    for (unsigned int i = 0; i < d_failureThreshold * 2; i++) {
+        EXPECT_TRUE(d_strategy.allowCall());
+        d_strategy.registerSuccess();
+    }
+}
+
+TEST_F(LockFreeCountStrategy_F,
+       Given_IsOpen_When_LessThanThresholdFailsInInterval_Then_CallsAreAllowed)
+{
+    for (unsigned int i = 0; i < d_failureThreshold - 1; i++) {
+        EXPECT_TRUE(d_strategy.allowCall());
+        advanceTime();
+
+        d_strategy.registerFailure();
+    }
+    EXPECT_TRUE(d_strategy.allowCall());
+}
+
+TEST_F(LockFreeCountStrategy_F, Given_IsOpen_When_RequestsFail_Then_CallsAreShortcircuited)
+{
+    for (unsigned int i = 0; i < d_failureThreshold; i++) {
+        EXPECT_TRUE(d_strategy.allowCall());
+
+        advanceTime();
+
+        d_strategy.registerFailure();
+    }
+
+    EXPECT_FALSE(d_strategy.allowCall());
+}
+
+TEST_F(LockFreeCountStrategy_F, Given_IsOpen_When_FailuresAreInDifferentIntervals_Then_Allow)
+{
+    for (unsigned int i = 0; i < d_failureThreshold * 2; i++) {
+        advanceTime(d_failureInterval + 1ms);
+        d_strategy.registerFailure();
+        EXPECT_TRUE(d_strategy.allowCall());
+    }
+}
+
+TEST_F(LockFreeCountStrategy_F, Given_IsShortcircuited_When_RequestArriveInInterval_Then_NotAllow)
+{
+    triggerShortcircuit();
+    for (unsigned int i = 0; i < 100; i++) {
+        advanceTime();
+        EXPECT_FALSE(d_strategy.allowCall());
+    }
+}
+
+TEST_F(LockFreeCountStrategy_F, Given_IsShortcircuited_When_EnoughTimeIsPassed_Then_Allow)
+{
+    triggerShortcircuit();
+    advanceTime(d_tripDuration);
+    EXPECT_TRUE(d_strategy.allowCall());
+}
+
+TEST_F(LockFreeCountStrategy_F, Given_IsTryingToLetThrough_When_RequestFails_Then_NotAllow)
+{
+    triggerShortcircuit();
+    advanceTime(d_tripDuration);
+    EXPECT_TRUE(d_strategy.allowCall());
+    d_strategy.registerFailure();
+    EXPECT_FALSE(d_strategy.allowCall());
+}
+
+TEST_F(LockFreeCountStrategy_F, Given_IsTryingToLetThrough_When_EnoughRequestsSucceed_Then_Recover)
+{
+    triggerShortcircuit();
+    advanceTime(d_tripDuration);
+    for (unsigned int i = 0; i < d_recoverSuccesses; i++) {
+        EXPECT_TRUE(d_strategy.allowCall());
+        d_strategy.registerSuccess();
+    }
+
+    // The failures before the trip are forgotten
+    for (unsigned int i = 0; i < d_failureThreshold - 1; i++) {
+        advanceTime();
+        d_strategy.registerFailure();
+        EXPECT_TRUE(d_strategy.allowCall());
+    }
+    advanceTime();
+    d_strategy.registerFailure();
+    EXPECT_FALSE(d_strategy.allowCall());
+}
+
+namespace {
+
+template<typename Strategy>
+struct LockFreeCountStrategyCounters_F : ::testing::Test
+{
+};
+
+using Strategies =
+    ::testing::Types<LockFreeCountStrategy<>,
+                     LockFreeCountStrategy<std::chrono::steady_clock, ShardedFailureCounter<>>>;
+
+} // namespace
+
+TYPED_TEST_CASE(LockFreeCountStrategyCounters_F, Strategies);
+
+TYPED_TEST(LockFreeCountStrategyCounters_F, When_ManyThreadsFail_Then_TheCircuitbreakerTrips)
+{
+    const unsigned long failures = 1000;
+    TypeParam strategy{failures, 1h, 1h, 1};
+
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 4; i++) {
+        threads.emplace_back([&strategy]() {
+            for (unsigned long j = 0; j < failures / 4; j++) {
+                if (strategy.allowCall()) {
+                    strategy.registerSuccess();
+                }
+                strategy.registerFailure();
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    EXPECT_FALSE(strategy.allowCall());
+}
+
+namespace {
+
+struct LockFreeCountStrategyProbes_F : ::testing::Test
+{
+    LockFreeCountStrategyProbes_F()
+    : d_clockState()
+    , d_maxProbes(2)
+    , d_strategy(1,
+                 60s,
+                 30s,
+                 3,
+                 d_maxProbes,
+                 ClockMock(setStrategyCtorExpectations(&d_clockState)))
+    , d_currentTime(0)
+    {
+        EXPECT_CALL(d_clockState, now())
+            .WillRepeatedly(::testing::Invoke(this, &LockFreeCountStrategyProbes_F::testTime));
+    }
+
+    StrictClockMockState d_clockState;
+    unsigned long d_maxProbes;
+    LockFreeCountStrategy<ClockMock> d_strategy;
+    std::chrono::seconds d_currentTime;
+
+    time_point testTime() { return time_point(d_currentTime); }
+
+    void tripAndWait()
+    {
+        d_strategy.registerFailure();
+        EXPECT_FALSE(d_strategy.allowCall());
+        d_currentTime += 30s;
+    }
+};
+
+} // namespace
+
+TEST_F(LockFreeCountStrategyProbes_F,
+       Given_IsTryingToLetThrough_When_ProbesAreRunning_Then_OthersAreNotAllowed)
+{
+    tripAndWait();
+    for (unsigned int i = 0; i < d_maxProbes; i++) {
+        EXPECT_TRUE(d_strategy.allowCall());
+    }
+    EXPECT_FALSE(d_strategy.allowCall());
+}
+
+TEST_F(LockFreeCountStrategyProbes_F,
+       Given_IsTryingToLetThrough_When_AProbeSucceeds_Then_AnotherIsAllowed)
+{
+    tripAndWait();
+    EXPECT_TRUE(d_strategy.allowCall());
+    EXPECT_TRUE(d_strategy.allowCall());
+    d_strategy.registerSuccess();
+    EXPECT_TRUE(d_strategy.allowCall());
+    EXPECT_FALSE(d_strategy.allowCall());
+}
+
+TEST_F(LockFreeCountStrategyProbes_F,
+       Given_IsTryingToLetThrough_When_ProbesRecover_Then_AllCallsAreAllowed)
+{
+    tripAndWait();
+    for (unsigned int i = 0; i < 3; i++) {
+        EXPECT_TRUE(d_strategy.allowCall());
+        d_strategy.registerSuccess();
+    }
+    for (unsigned int i = 0; i < d_maxProbes * 2; i++) {
+        EXPECT_TRUE(d_strategy.allowCall());
+    }
+}
+
+TEST_F(LockFreeCountStrategyProbes_F,
+       Given_IsTryingToLetThrough_When_AProbeFails_Then_TheProbesAreReleased)
+{
+    tripAndWait();
+    EXPECT_TRUE(d_strategy.allowCall());
+    EXPECT_TRUE(d_strategy.allowCall());
+    d_strategy.registerFailure();
+    EXPECT_FALSE(d_strategy.allowCall());
+    d_currentTime += 30s;
+    EXPECT_TRUE(d_strategy.allowCall());
+    EXPECT_TRUE(d_strategy.allowCall());
+}
+
+TEST_F(LockFreeCountStrategyProbes_F,
+       Given_IsTryingToLetThrough_When_CallsAllowedBeforeTheTripEnd_Then_TheyAreIgnored)
+{
+    tripAndWait();
+    for (unsigned int i = 0; i < d_maxProbes; i++) {
+        EXPECT_TRUE(d_strategy.allowCall());
+    }
+    // Calls allowed before the trip end on another thread: they took no slot
+    std::thread([this]() {
+        for (int i = 0; i < 3; i++) {
+            d_strategy.registerSuccess();
+        }
+        d_strategy.registerFailure();
+    }).join();
+    // The slots of the probes are still taken, and it didn't recover nor trip
+    EXPECT_FALSE(d_strategy.allowCall());
+    d_strategy.registerSuccess();
+    EXPECT_TRUE(d_strategy.allowCall());
+}
+
+TEST_F(LockFreeCountStrategyProbes_F,
+       Given_IsTryingToLetThrough_When_TheProbesAreLostForTheTripDuration_Then_ANewPeriodStarts)
+{
+    tripAndWait();
+    for (unsigned int i = 0; i < d_maxProbes; i++) {
+        EXPECT_TRUE(d_strategy.allowCall());
+    }
+    // The probes are never registered
+    d_currentTime += 29s;
+    EXPECT_FALSE(d_strategy.allowCall());
+    d_currentTime += 1s;
+    for (unsigned int i = 0; i < d_maxProbes; i++) {
+        EXPECT_TRUE(d_strategy.allowCall());
+    }
+    EXPECT_FALSE(d_strategy.allowCall());
+}
+
+TEST(LockFreeCountStrategy, When_NoProbeIsAllowed_Then_TheConstructorThrows)
+{
+    EXPECT_THROW(LockFreeCountStrategy<std::chrono::steady_clock>(1, 60s, 30s, 3, 0),
+                 std::invalid_argument);
+}
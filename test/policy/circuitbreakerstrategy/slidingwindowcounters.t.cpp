@@ -0,0 +1,57 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <resilient/policy/circuitbreakerstrategy/slidingwindowcounters.hpp>
+
+using namespace resilient;
+
+TEST(SlidingWindowCounters, When_AddingToBucketsInTheWindow_Then_TheyAreSummed)
+{
+    detail::SlidingWindowCounters<2> counters{4};
+    counters.add(10, 0);
+    counters.add(11, 0);
+    counters.add(11, 1);
+    counters.add(13, 1);
+
+    auto counts = counters.sum(13);
+    EXPECT_EQ(counts[0], 2u);
+    EXPECT_EQ(counts[1], 2u);
+}
+
+TEST(SlidingWindowCounters, When_TheWindowMovesPastABucket_Then_ItIsNotSummed)
+{
+    detail::SlidingWindowCounters<1> counters{4};
+    counters.add(10, 0);
+    counters.add(11, 0);
+
+    EXPECT_EQ(counters.sum(14)[0], 1u);
+    EXPECT_EQ(counters.sum(15)[0], 0u);
+}
+
+TEST(SlidingWindowCounters, When_ABucketIsReused_Then_ItStartsFromZero)
+{
+    detail::SlidingWindowCounters<1> counters{4};
+    counters.add(10, 0);
+    counters.add(10, 0);
+    counters.add(14, 0);
+
+    EXPECT_EQ(counters.sum(14)[0], 1u);
+}
+
+TEST(SlidingWindowCounters, When_AddingToABucketOutOfTheWindow_Then_ItIsIgnored)
+{
+    detail::SlidingWindowCounters<1> counters{4};
+    counters.add(14, 0);
+    counters.add(10, 0);
+
+    EXPECT_EQ(counters.sum(14)[0], 1u);
+}
+
+TEST(SlidingWindowCounters, When_Reset_Then_AllCountersAreZero)
+{
+    detail::SlidingWindowCounters<1> counters{4};
+    counters.add(10, 0);
+    counters.reset();
+
+    EXPECT_EQ(counters.sum(10)[0], 0u);
+}
@@ -0,0 +1,120 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <resilient/policy/circuitbreakerstrategy/slidingwindowstrategy.hpp>
+#include <test/common/clockmock.t.hpp>
+
+#include <chrono>
+#include <stdexcept>
+
+using namespace resilient;
+using namespace std::chrono_literals;
+
+using resilient::test::ClockMock;
+using resilient::test::StrictClockMockState;
+
+namespace {
+
+struct SlidingWindowStrategy_F : ::testing::Test
+{
+    SlidingWindowStrategy_F()
+    : d_clockState()
+    , d_minimumCalls(4)
+    , d_tripDuration(30)
+    , d_recoverSuccesses(2)
+    , d_strategy(0.5, d_minimumCalls, 10s, 10, d_tripDuration, d_recoverSuccesses, &d_clockState)
+    , d_currentTime(0)
+    {
+        EXPECT_CALL(d_clockState, now())
+            .WillRepeatedly(::testing::Invoke(this, &SlidingWindowStrategy_F::testTime));
+    }
+
+    StrictClockMockState d_clockState;
+    unsigned long d_minimumCalls;
+    std::chrono::seconds d_tripDuration;
+    unsigned long d_recoverSuccesses;
+    SlidingWindowStrategy<ClockMock> d_strategy;
+
+    // Used to trace time in the tests
+    std::chrono::milliseconds d_currentTime;
+
+    ClockMock::time_point testTime() { return ClockMock::time_point(d_currentTime); }
+
+    void advanceTime(std::chrono::milliseconds delta) { d_currentTime += delta; }
+
+    void calls(unsigned int successes, unsigned int failures)
+    {
+        for (unsigned int i = 0; i < successes; i++) {
+            d_strategy.registerSuccess();
+        }
+        for (unsigned int i = 0; i < failures; i++) {
+            d_strategy.registerFailure();
+        }
+    }
+};
+
+} // namespace
+
+TEST_F(SlidingWindowStrategy_F, Given_IsOpen_When_LessThanMinimumCalls_Then_CallsAreAllowed)
+{
+    calls(0, d_minimumCalls - 1);
+    EXPECT_TRUE(d_strategy.allowCall());
+}
+
+TEST_F(SlidingWindowStrategy_F, Given_IsOpen_When_FailureRateIsBelowThreshold_Then_CallsAreAllowed)
+{
+    calls(3, 2);
+    EXPECT_TRUE(d_strategy.allowCall());
+}
+
+TEST_F(SlidingWindowStrategy_F, Given_IsOpen_When_FailureRateReachesThreshold_Then_Shortcircuit)
+{
+    calls(2, 2);
+    EXPECT_FALSE(d_strategy.allowCall());
+}
+
+TEST_F(SlidingWindowStrategy_F, Given_IsOpen_When_FailuresStraddleABucketBoundary_Then_Shortcircuit)
+{
+    advanceTime(9500ms);
+    calls(0, 2);
+    advanceTime(1s);
+    calls(0, 2);
+    EXPECT_FALSE(d_strategy.allowCall());
+}
+
+TEST_F(SlidingWindowStrategy_F, Given_IsOpen_When_FailuresLeaveTheWindow_Then_TheyAreNotCounted)
+{
+    calls(0, 3);
+    advanceTime(11s);
+    calls(0, 3);
+    EXPECT_TRUE(d_strategy.allowCall());
+}
+
+TEST_F(SlidingWindowStrategy_F, Given_IsShortcircuited_When_EnoughTimeIsPassed_Then_Allow)
+{
+    calls(0, d_minimumCalls);
+    advanceTime(d_tripDuration - 1ms);
+    EXPECT_FALSE(d_strategy.allowCall());
+    advanceTime(1ms);
+    EXPECT_TRUE(d_strategy.allowCall());
+}
+
+TEST_F(SlidingWindowStrategy_F, Given_HasRecovered_When_RequestsFail_Then_OldFailuresAreForgotten)
+{
+    calls(0, d_minimumCalls);
+    advanceTime(d_tripDuration);
+    EXPECT_TRUE(d_strategy.allowCall());
+    calls(d_recoverSuccesses, 0);
+
+    calls(0, d_minimumCalls - 1);
+    EXPECT_TRUE(d_strategy.allowCall());
+}
+
+TEST(SlidingWindowStrategy, When_TheWindowCantBeDividedInBuckets_Then_TheConstructorThrows)
+{
+    using Strategy = SlidingWindowStrategy<std::chrono::steady_clock>;
+    EXPECT_THROW(Strategy(0.5, 4, 10s, 0, 30s, 2), std::invalid_argument);
+    // Shorter than a nanosecond each
+    EXPECT_THROW(Strategy(0.5, 4, 1us, 10000, 30s, 2), std::invalid_argument);
+    EXPECT_NO_THROW(Strategy(0.5, 4, 1us, 1000, 30s, 2));
+}
@@ -0,0 +1,151 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <resilient/policy/circuitbreakerstrategy/slowcallstrategy.hpp>
+#include <test/common/clockmock.t.hpp>
+
+#include <chrono>
+#include <stdexcept>
+
+using namespace resilient;
+using namespace std::chrono_literals;
+
+using resilient::test::ClockMock;
+using resilient::test::StrictClockMockState;
+
+namespace {
+
+struct SlowCallStrategy_F : ::testing::Test
+{
+    SlowCallStrategy_F()
+    : d_clockState()
+    , d_tripDuration(30)
+    , d_strategy(100ms, 0.5, 0.9, 1s, 4, 10s, 10, d_tripDuration, 1, &d_clockState)
+    , d_currentTime(0)
+    {
+        EXPECT_CALL(d_clockState, now())
+            .WillRepeatedly(::testing::Invoke(this, &SlowCallStrategy_F::testTime));
+    }
+
+    StrictClockMockState d_clockState;
+    std::chrono::seconds d_tripDuration;
+    SlowCallStrategy<ClockMock> d_strategy;
+
+    // Used to trace time in the tests
+    std::chrono::milliseconds d_currentTime;
+
+    ClockMock::time_point testTime() { return ClockMock::time_point(d_currentTime); }
+
+    void advanceTime(std::chrono::milliseconds delta) { d_currentTime += delta; }
+
+    void calls(unsigned int count, std::chrono::nanoseconds duration)
+    {
+        for (unsigned int i = 0; i < count; i++) {
+            d_strategy.registerTimedSuccess(duration);
+        }
+    }
+};
+
+} // namespace
+
+TEST(LatencyBins, When_MappingADuration_Then_ItIsWithinTheBoundsOfItsBin)
+{
+    for (std::chrono::microseconds duration :
+         {0us, 1us, 3us, 4us, 7us, 1000us, 123456us, 10000000us})
+    {
+        auto bin = detail::LatencyBins::binOf(duration);
+        EXPECT_LE(detail::LatencyBins::lowerBound(bin), duration);
+        EXPECT_GT(detail::LatencyBins::upperBound(bin), duration);
+    }
+}
+
+TEST_F(SlowCallStrategy_F, When_Constructed_Then_ItNeedsTheCallDuration)
+{
+    EXPECT_TRUE(d_strategy.needsCallDuration());
+}
+
+TEST_F(SlowCallStrategy_F, Given_IsOpen_When_CallsAreFast_Then_CallsAreAllowed)
+{
+    calls(10, 1ms);
+    EXPECT_TRUE(d_strategy.allowCall());
+}
+
+TEST_F(SlowCallStrategy_F, Given_IsOpen_When_LessThanMinimumCallsAreSlow_Then_CallsAreAllowed)
+{
+    calls(3, 200ms);
+    EXPECT_TRUE(d_strategy.allowCall());
+}
+
+TEST_F(SlowCallStrategy_F, Given_IsOpen_When_SlowCallRateIsReached_Then_Shortcircuit)
+{
+    calls(2, 1ms);
+    EXPECT_TRUE(d_strategy.allowCall());
+    calls(2, 200ms);
+    EXPECT_FALSE(d_strategy.allowCall());
+}
+
+TEST_F(SlowCallStrategy_F, Given_IsOpen_When_FailedCallsAreSlow_Then_Shortcircuit)
+{
+    calls(2, 1ms);
+    d_strategy.registerTimedFailure(200ms);
+    d_strategy.registerTimedFailure(200ms);
+    EXPECT_FALSE(d_strategy.allowCall());
+}
+
+TEST_F(SlowCallStrategy_F, Given_IsOpen_When_PercentileReachesLimit_Then_Shortcircuit)
+{
+    calls(9, 1ms);
+    calls(1, 2s);
+    EXPECT_TRUE(d_strategy.allowCall());
+    calls(1, 2s);
+    EXPECT_FALSE(d_strategy.allowCall());
+}
+
+TEST_F(SlowCallStrategy_F, Given_IsOpen_When_ABinReachesTheLimit_Then_Shortcircuit)
+{
+    // Never trip because of slow calls
+    SlowCallStrategy<ClockMock> strategy(
+        std::chrono::microseconds::max(), 2, 0.9, 1s, 4, 10s, 10, d_tripDuration, 1, &d_clockState);
+    for (int i = 0; i < 9; i++) {
+        strategy.registerTimedSuccess(1ms);
+    }
+    strategy.registerTimedSuccess(999ms);
+    EXPECT_TRUE(strategy.allowCall());
+    // Below the limit, but its bin reaches it
+    strategy.registerTimedSuccess(999ms);
+    EXPECT_FALSE(strategy.allowCall());
+}
+
+TEST_F(SlowCallStrategy_F, Given_IsOpen_When_SlowCallsLeaveTheWindow_Then_TheyAreNotCounted)
+{
+    calls(3, 200ms);
+    advanceTime(11s);
+    calls(2, 1ms);
+    calls(1, 200ms);
+    EXPECT_TRUE(d_strategy.allowCall());
+}
+
+TEST_F(SlowCallStrategy_F, When_AskingForAPercentile_Then_AnUpperBoundIsReturned)
+{
+    calls(90, 1ms);
+    calls(10, 500ms);
+    EXPECT_GT(d_strategy.percentileDuration(0.5), 1ms);
+    EXPECT_LT(d_strategy.percentileDuration(0.5), 2ms);
+    EXPECT_GT(d_strategy.percentileDuration(0.95), 500ms);
+    EXPECT_LT(d_strategy.percentileDuration(0.95), 700ms);
+}
+
+TEST_F(SlowCallStrategy_F, Given_IsShortcircuited_When_EnoughTimeIsPassed_Then_Allow)
+{
+    calls(4, 200ms);
+    EXPECT_FALSE(d_strategy.allowCall());
+    advanceTime(d_tripDuration);
+    EXPECT_TRUE(d_strategy.allowCall());
+}
+
+TEST(SlowCallStrategy, When_TheWindowCantBeDividedInBuckets_Then_TheConstructorThrows)
+{
+    using Strategy = SlowCallStrategy<std::chrono::steady_clock>;
+    EXPECT_THROW(Strategy(100ms, 0.5, 0.9, 1s, 4, 10s, 0, 30s, 1), std::invalid_argument);
+    EXPECT_THROW(Strategy(100ms, 0.5, 0.9, 1s, 4, 1us, 10000, 30s, 1), std::invalid_argument);
+}
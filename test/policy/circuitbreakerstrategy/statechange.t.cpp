@@ -0,0 +1,189 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <resilient/detail/spscqueue.hpp>
+#include <resilient/policy/circuitbreakerstrategy/countstrategy.hpp>
+#include <resilient/policy/circuitbreakerstrategy/lockfreecountstrategy.hpp>
+#include <resilient/policy/circuitbreakerstrategy/statechange.hpp>
+#include <test/common/clockmock.t.hpp>
+
+#include <chrono>
+#include <future>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using namespace resilient;
+using namespace std::chrono_literals;
+
+using resilient::test::ClockMock;
+using resilient::test::StrictClockMockState;
+
+namespace {
+
+template<typename Strategy>
+struct StateChange_F : ::testing::Test
+{
+    StateChange_F()
+    : d_clockState()
+    , d_currentTime(0)
+    , d_strategy(1, 60s, 30s, 1, ClockMock(useTestTime()))
+    , d_queue(std::make_shared<StateChangeQueue>(8))
+    {
+        d_strategy.notifyStateChangesTo(d_queue);
+    }
+
+    // The strategies might read the clock in their constructor
+    StrictClockMockState* useTestTime()
+    {
+        EXPECT_CALL(d_clockState, now())
+            .WillRepeatedly(::testing::Invoke(this, &StateChange_F::testTime));
+        return &d_clockState;
+    }
+
+    ClockMock::time_point testTime() { return ClockMock::time_point(d_currentTime); }
+
+    void expectChange(CircuitbreakerState from, CircuitbreakerState to)
+    {
+        CircuitbreakerStateChange change;
+        ASSERT_TRUE(d_queue->pop(change));
+        EXPECT_EQ(change.strategy, &d_strategy);
+        EXPECT_EQ(change.from, from);
+        EXPECT_EQ(change.to, to);
+    }
+
+    StrictClockMockState d_clockState;
+    std::chrono::seconds d_currentTime;
+    Strategy d_strategy;
+    std::shared_ptr<StateChangeQueue> d_queue;
+};
+
+using Strategies = ::testing::Types<CountStrategy<ClockMock>, LockFreeCountStrategy<ClockMock>>;
+
+} // namespace
+
+TYPED_TEST_CASE(StateChange_F, Strategies);
+
+TYPED_TEST(StateChange_F, When_CallsDontChangeState_Then_NothingIsPushed)
+{
+    EXPECT_TRUE(this->d_strategy.allowCall());
+    this->d_strategy.registerSuccess();
+    EXPECT_TRUE(this->d_queue->empty());
+}
+
+TYPED_TEST(StateChange_F, When_TheStateChanges_Then_EachChangeIsPushed)
+{
+    this->d_strategy.registerFailure();
+    EXPECT_FALSE(this->d_strategy.allowCall());
+    this->d_currentTime += 30s;
+    EXPECT_TRUE(this->d_strategy.allowCall());
+    this->d_strategy.registerFailure();
+    this->d_currentTime += 30s;
+    EXPECT_TRUE(this->d_strategy.allowCall());
+    this->d_strategy.registerSuccess();
+
+    this->expectChange(CircuitbreakerState::Closed, CircuitbreakerState::Open);
+    this->expectChange(CircuitbreakerState::Open, CircuitbreakerState::HalfOpen);
+    this->expectChange(CircuitbreakerState::HalfOpen, CircuitbreakerState::Open);
+    this->expectChange(CircuitbreakerState::Open, CircuitbreakerState::HalfOpen);
+    this->expectChange(CircuitbreakerState::HalfOpen, CircuitbreakerState::Closed);
+    EXPECT_TRUE(this->d_queue->empty());
+}
+
+TEST(SpscQueue, When_ElementsArePushed_Then_TheyArePoppedInOrder)
+{
+    detail::SpscQueue<int> queue(3);
+    EXPECT_TRUE(queue.push(1));
+    EXPECT_TRUE(queue.push(2));
+    int element = 0;
+    EXPECT_TRUE(queue.pop(element));
+    EXPECT_EQ(element, 1);
+    EXPECT_TRUE(queue.pop(element));
+    EXPECT_EQ(element, 2);
+    EXPECT_FALSE(queue.pop(element));
+}
+
+TEST(SpscQueue, When_TheQueueIsFull_Then_PushFails)
+{
+    // The capacity is rounded up to a power of two
+    detail::SpscQueue<int> queue(3);
+    for (int i = 0; i < 4; i++) {
+        EXPECT_TRUE(queue.push(i));
+    }
+    EXPECT_FALSE(queue.push(4));
+    int element = 0;
+    EXPECT_TRUE(queue.pop(element));
+    EXPECT_TRUE(queue.push(4));
+}
+
+TEST(StateChangeDispatcher, When_StrategiesChangeState_Then_TheObserverIsCalled)
+{
+    std::vector<CircuitbreakerStateChange> changes;
+    CountStrategy<> strategy(1, 60s, 30s, 1);
+    {
+        StateChangeDispatcher dispatcher(
+            [&changes](const CircuitbreakerStateChange& change) { changes.push_back(change); });
+        strategy.notifyStateChangesTo(dispatcher.newQueue());
+        strategy.registerFailure();
+        // The dispatcher delivers the pending changes before stopping
+    }
+    ASSERT_EQ(changes.size(), 1u);
+    EXPECT_EQ(changes[0].strategy, &strategy);
+    EXPECT_EQ(changes[0].from, CircuitbreakerState::Closed);
+    EXPECT_EQ(changes[0].to, CircuitbreakerState::Open);
+}
+
+TEST(StateChangeDispatcher, When_AStrategyChangesStateWhileTheDispatcherSleeps_Then_ItIsWoken)
+{
+    CountStrategy<> strategy(1, 60s, 30s, 1);
+    std::promise<CircuitbreakerStateChange> delivered;
+    StateChangeDispatcher dispatcher(
+        [&delivered](const CircuitbreakerStateChange& change) { delivered.set_value(change); });
+    strategy.notifyStateChangesTo(dispatcher.newQueue());
+    // Let the dispatcher find the queue empty and go to sleep
+    std::this_thread::sleep_for(20ms);
+
+    strategy.registerFailure();
+    auto future = delivered.get_future();
+    ASSERT_EQ(future.wait_for(5s), std::future_status::ready);
+    EXPECT_EQ(future.get().to, CircuitbreakerState::Open);
+}
+
+TEST(LockFreeCountStrategy, When_ManyThreadsChangeState_Then_EachChangeFollowsThePrevious)
+{
+    // The trip ends immediately, so the threads keep switching between all the states
+    LockFreeCountStrategy<> strategy(1, 60s, 0s, 2);
+    auto queue = std::make_shared<StateChangeQueue>(1u << 16);
+    strategy.notifyStateChangesTo(queue);
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; t++) {
+        threads.emplace_back([&strategy, t]() {
+            for (int i = 0; i < 2000; i++) {
+                if (strategy.allowCall()) {
+                    if ((i + t) % 3 == 0) {
+                        strategy.registerFailure();
+                    }
+                    else
+                    {
+                        strategy.registerSuccess();
+                    }
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    CircuitbreakerState current = CircuitbreakerState::Closed;
+    CircuitbreakerStateChange change;
+    int changes = 0;
+    while (queue->pop(change)) {
+        ASSERT_EQ(change.from, current) << "change " << changes;
+        EXPECT_NE(change.to, change.from);
+        current = change.to;
+        changes++;
+    }
+    EXPECT_GT(changes, 0);
+}
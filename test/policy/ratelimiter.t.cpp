@@ -1,7 +1,9 @@
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
+#include <stdexcept>
 #include <utility>
+#include <vector>
 
 #include <resilient/policy/ratelimiter.hpp>
 #include <test/policy/policy_common.t.hpp>
@@ -24,6 +26,27 @@ struct RateLimiterStrategyMock : IRateLimiterStrategyMock
     MOCK_METHOD1(release, void(int));
 };
 
+using INonBlockingRateLimiterStrategyMock =
+    INonBlockingRateLimiterStrategy<int, RateLimiterStrategyError>;
+struct NonBlockingRateLimiterStrategyMock : INonBlockingRateLimiterStrategyMock
+{
+    using acquire_return_type = Variant<int, RateLimiterStrategyError>;
+
+    MOCK_METHOD0(acquire, acquire_return_type());
+    MOCK_METHOD0(tryAcquire, acquire_return_type());
+    MOCK_METHOD1(release, void(int));
+};
+
+struct WeightedRateLimiterStrategyMock : IRateLimiterStrategyMock,
+                                         IWeightedRateLimiterStrategy<int, RateLimiterStrategyError>
+{
+    using acquire_return_type = Variant<int, RateLimiterStrategyError>;
+
+    MOCK_METHOD0(acquire, acquire_return_type());
+    MOCK_METHOD1(acquire, acquire_return_type(unsigned long));
+    MOCK_METHOD1(release, void(int));
+};
+
 } // namespace
 
 TEST_F(SinglePolicies, AcquireReleaseAreInvoked)
@@ -56,4 +79,176 @@ TEST_F(MultiPolicies, When_StrategyFailsToAcquire_Then_NoCallToCallableAndToRele
     Ratelimiter<RateLimiterStrategyMock> rl(std::move(strategy));
     auto result = rl.execute(d_callable);
     EXPECT_TRUE(holds_failure(result));
-}
\ No newline at end of file
+}
+TEST_F(SinglePolicies, When_TryingToExecute_Then_TryAcquireIsInvokedInsteadOfAcquire)
+{
+    std::unique_ptr<NonBlockingRateLimiterStrategyMock> strategy{
+        new testing::StrictMock<NonBlockingRateLimiterStrategyMock>()};
+
+    int token = 123;
+    EXPECT_CALL(d_callable, call()).WillOnce(testing::Return(SingleFailureFailable(Failure())));
+    EXPECT_CALL(*strategy, tryAcquire())
+        .WillOnce(
+            testing::Return(NonBlockingRateLimiterStrategyMock::acquire_return_type{token}));
+    EXPECT_CALL(*strategy, release(testing::Eq(token))).Times(1);
+
+    Ratelimiter<NonBlockingRateLimiterStrategyMock> rl(std::move(strategy));
+    auto result = rl.tryExecute(d_callable);
+    EXPECT_TRUE(holds_failure(result));
+}
+
+TEST_F(MultiPolicies, When_StrategyFailsToTryAcquire_Then_NoCallToCallableAndToRelease)
+{
+    std::unique_ptr<NonBlockingRateLimiterStrategyMock> strategy{
+        new testing::StrictMock<NonBlockingRateLimiterStrategyMock>()};
+
+    EXPECT_CALL(d_callable, call()).Times(0);
+    EXPECT_CALL(*strategy, tryAcquire())
+        .WillOnce(testing::Return(
+            NonBlockingRateLimiterStrategyMock::acquire_return_type{RateLimiterStrategyError()}));
+    EXPECT_CALL(*strategy, release(testing::An<int>())).Times(0);
+
+    Ratelimiter<NonBlockingRateLimiterStrategyMock> rl(std::move(strategy));
+    auto result = rl.tryExecute(d_callable);
+    EXPECT_TRUE(holds_failure(result));
+}
+
+TEST_F(SinglePolicies, When_ExecutingWithAWeight_Then_TheWeightIsAcquired)
+{
+    std::unique_ptr<WeightedRateLimiterStrategyMock> strategy{
+        new testing::StrictMock<WeightedRateLimiterStrategyMock>()};
+
+    int token = 123;
+    EXPECT_CALL(d_callable, call()).WillOnce(testing::Return(SingleFailureFailable(Failure())));
+    EXPECT_CALL(*strategy, acquire(50ul))
+        .WillOnce(testing::Return(WeightedRateLimiterStrategyMock::acquire_return_type{token}));
+    EXPECT_CALL(*strategy, release(testing::Eq(token))).Times(1);
+
+    Ratelimiter<WeightedRateLimiterStrategyMock> rl(std::move(strategy));
+    auto result = rl.executeWeighted(50, d_callable);
+    EXPECT_TRUE(holds_failure(result));
+}
+
+TEST(Ratelimiter, When_ExecutingWithAWeightComputedFromTheArguments_Then_TheWeightIsAcquired)
+{
+    std::unique_ptr<WeightedRateLimiterStrategyMock> strategy{
+        new testing::StrictMock<WeightedRateLimiterStrategyMock>()};
+
+    int token = 123;
+    EXPECT_CALL(*strategy, acquire(3ul))
+        .WillOnce(testing::Return(WeightedRateLimiterStrategyMock::acquire_return_type{token}));
+    EXPECT_CALL(*strategy, release(testing::Eq(token))).Times(1);
+
+    Ratelimiter<WeightedRateLimiterStrategyMock> rl(std::move(strategy));
+    std::vector<int> batch{1, 2, 3};
+    auto result = rl.executeWeightedBy(
+        [](const std::vector<int>& values) { return values.size(); },
+        [](std::vector<int> values) { return Failable<int, Failure>(values.back()); },
+        std::move(batch));
+    ASSERT_TRUE(holds_value(result));
+    EXPECT_EQ(get_value(result), 3);
+}
+
+TEST(Ratelimiter, When_ExecutingABatch_Then_APermitForAllTheTasksIsAcquiredOnce)
+{
+    std::unique_ptr<WeightedRateLimiterStrategyMock> strategy{
+        new testing::StrictMock<WeightedRateLimiterStrategyMock>()};
+
+    int token = 123;
+    EXPECT_CALL(*strategy, acquire(3ul))
+        .WillOnce(testing::Return(WeightedRateLimiterStrategyMock::acquire_return_type{token}));
+    EXPECT_CALL(*strategy, release(testing::Eq(token))).Times(1);
+
+    Ratelimiter<WeightedRateLimiterStrategyMock> rl(std::move(strategy));
+    std::vector<int> values{1, 2, 3};
+    auto results = rl.executeBatch(values.begin(), values.end(), [](int value) {
+        return Failable<int, Failure>(value * 2);
+    });
+    ASSERT_EQ(results.size(), 3u);
+    for (std::size_t i = 0; i < results.size(); i++) {
+        ASSERT_TRUE(holds_value(results[i]));
+        EXPECT_EQ(get_value(results[i]), values[i] * 2);
+    }
+}
+
+TEST(Ratelimiter, When_ABatchIsNotAllowed_Then_AllTheResultsAreTheError)
+{
+    std::unique_ptr<WeightedRateLimiterStrategyMock> strategy{
+        new testing::StrictMock<WeightedRateLimiterStrategyMock>()};
+
+    EXPECT_CALL(*strategy, acquire(2ul))
+        .WillOnce(testing::Return(
+            WeightedRateLimiterStrategyMock::acquire_return_type{RateLimiterStrategyError()}));
+    EXPECT_CALL(*strategy, release(testing::An<int>())).Times(0);
+
+    Ratelimiter<WeightedRateLimiterStrategyMock> rl(std::move(strategy));
+    std::vector<int> values{1, 2};
+    int calls = 0;
+    auto results = rl.executeBatch(values.begin(), values.end(), [&calls](int value) {
+        calls++;
+        return Failable<int, Failure>(value);
+    });
+    EXPECT_EQ(calls, 0);
+    ASSERT_EQ(results.size(), 2u);
+    for (auto& result : results) {
+        ASSERT_TRUE(holds_failure(result));
+        EXPECT_TRUE(holds_alternative<RateLimiterStrategyError>(get_failure(result)));
+    }
+}
+
+TEST(Ratelimiter, When_ExecutingAnEmptyBatch_Then_NoPermitIsAcquired)
+{
+    std::unique_ptr<WeightedRateLimiterStrategyMock> strategy{
+        new testing::StrictMock<WeightedRateLimiterStrategyMock>()};
+
+    Ratelimiter<WeightedRateLimiterStrategyMock> rl(std::move(strategy));
+    std::vector<int> values;
+    auto results = rl.executeBatch(values.begin(), values.end(), [](int value) {
+        return Failable<int, Failure>(value);
+    });
+    EXPECT_TRUE(results.empty());
+}
+
+TEST(Ratelimiter, When_ABatchIsSplit_Then_EachChunkIsAllowedOrRejectedOnItsOwn)
+{
+    std::unique_ptr<WeightedRateLimiterStrategyMock> strategy{
+        new testing::StrictMock<WeightedRateLimiterStrategyMock>()};
+
+    int token = 123;
+    testing::InSequence sequence;
+    EXPECT_CALL(*strategy, acquire(2ul))
+        .WillOnce(testing::Return(WeightedRateLimiterStrategyMock::acquire_return_type{token}));
+    EXPECT_CALL(*strategy, release(testing::Eq(token))).Times(1);
+    EXPECT_CALL(*strategy, acquire(2ul))
+        .WillOnce(testing::Return(
+            WeightedRateLimiterStrategyMock::acquire_return_type{RateLimiterStrategyError()}));
+    EXPECT_CALL(*strategy, acquire(1ul))
+        .WillOnce(testing::Return(WeightedRateLimiterStrategyMock::acquire_return_type{token}));
+    EXPECT_CALL(*strategy, release(testing::Eq(token))).Times(1);
+
+    Ratelimiter<WeightedRateLimiterStrategyMock> rl(std::move(strategy));
+    std::vector<int> values{1, 2, 3, 4, 5};
+    auto results = rl.executeBatch(values.begin(), values.end(), 2, [](int value) {
+        return Failable<int, Failure>(value);
+    });
+    ASSERT_EQ(results.size(), 5u);
+    EXPECT_EQ(get_value(results[0]), 1);
+    EXPECT_EQ(get_value(results[1]), 2);
+    EXPECT_TRUE(holds_failure(results[2]));
+    EXPECT_TRUE(holds_failure(results[3]));
+    EXPECT_EQ(get_value(results[4]), 5);
+}
+
+TEST(Ratelimiter, When_TheChunksOfABatchWeighNothing_Then_ItThrows)
+{
+    std::unique_ptr<WeightedRateLimiterStrategyMock> strategy{
+        new testing::StrictMock<WeightedRateLimiterStrategyMock>()};
+
+    Ratelimiter<WeightedRateLimiterStrategyMock> rl(std::move(strategy));
+    std::vector<int> values{1};
+    EXPECT_THROW(rl.executeBatch(values.begin(),
+                                 values.end(),
+                                 0,
+                                 [](int value) { return Failable<int, Failure>(value); }),
+                 std::invalid_argument);
+}
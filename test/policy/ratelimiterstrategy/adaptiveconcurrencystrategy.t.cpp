@@ -0,0 +1,161 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <resilient/policy/ratelimiterstrategy/adaptiveconcurrencystrategy.hpp>
+#include <test/common/clockmock.t.hpp>
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+using namespace resilient;
+using namespace std::chrono_literals;
+
+using resilient::test::ClockMock;
+using resilient::test::StrictClockMockState;
+
+namespace {
+
+template<typename Limit>
+struct AdaptiveConcurrencyStrategy_F
+{
+    using Strategy = AdaptiveConcurrencyStrategy<Limit, ClockMock>;
+    using Permit = AdaptiveConcurrencyPermit<ClockMock>;
+
+    AdaptiveConcurrencyStrategy_F(Limit limit, unsigned long initialLimit)
+    : d_clockState()
+    , d_currentTime(0)
+    , d_strategy(std::move(limit), initialLimit, 1, 100, ClockMock(useTestTime()))
+    {
+    }
+
+    StrictClockMockState* useTestTime()
+    {
+        EXPECT_CALL(d_clockState, now())
+            .WillRepeatedly(::testing::Invoke([this]() {
+                return ClockMock::time_point(d_currentTime);
+            }));
+        return &d_clockState;
+    }
+
+    // Run `count` concurrent executions, each taking `latency`.
+    void execute(unsigned long count, std::chrono::milliseconds latency)
+    {
+        std::vector<Permit> permits;
+        for (unsigned long i = 0; i < count; i++) {
+            auto permit = d_strategy.acquire();
+            ASSERT_TRUE(holds_alternative<Permit>(permit));
+            permits.push_back(get<Permit>(permit));
+        }
+        d_currentTime += latency;
+        for (Permit& permit : permits) {
+            d_strategy.release(permit);
+        }
+    }
+
+    StrictClockMockState d_clockState;
+    std::chrono::milliseconds d_currentTime;
+    Strategy d_strategy;
+};
+
+} // namespace
+
+TEST(AdaptiveConcurrencyStrategy, When_TheLimitIsReached_Then_ExecutionsAreRejected)
+{
+    AdaptiveConcurrencyStrategy_F<AimdLimit> f{AimdLimit(100ms), 2};
+    auto first = f.d_strategy.acquire();
+    auto second = f.d_strategy.acquire();
+    EXPECT_TRUE(holds_alternative<AdaptiveConcurrencyPermit<ClockMock>>(first));
+    EXPECT_TRUE(holds_alternative<AdaptiveConcurrencyPermit<ClockMock>>(second));
+
+    auto third = f.d_strategy.acquire();
+    ASSERT_TRUE(holds_alternative<ConcurrencyLimitExceeded>(third));
+    EXPECT_EQ(get<ConcurrencyLimitExceeded>(third).limit, 2u);
+
+    f.d_strategy.release(get<AdaptiveConcurrencyPermit<ClockMock>>(first));
+    EXPECT_TRUE(
+        holds_alternative<AdaptiveConcurrencyPermit<ClockMock>>(f.d_strategy.tryAcquire()));
+}
+
+TEST(AdaptiveConcurrencyStrategy, When_TheLimitIsUpdated_Then_ItStaysWithinTheBounds)
+{
+    AdaptiveConcurrencyStrategy_F<AimdLimit> f{AimdLimit(100ms, 0.1), 500};
+    EXPECT_EQ(f.d_strategy.limit(), 100u);
+    for (int i = 0; i < 10; i++) {
+        f.execute(1, 200ms);
+    }
+    EXPECT_EQ(f.d_strategy.limit(), 1u);
+}
+
+TEST(AdaptiveConcurrencyStrategy, When_UsingAimdAndExecutionsAreFast_Then_TheLimitGrowsByOne)
+{
+    AdaptiveConcurrencyStrategy_F<AimdLimit> f{AimdLimit(100ms), 10};
+    // Only the executions started when at least half of the limit was used count
+    f.execute(10, 10ms);
+    EXPECT_EQ(f.d_strategy.limit(), 16u);
+}
+
+TEST(AdaptiveConcurrencyStrategy, When_UsingAimdAndTheLimitIsNotUsed_Then_ItDoesNotGrow)
+{
+    AdaptiveConcurrencyStrategy_F<AimdLimit> f{AimdLimit(100ms), 10};
+    f.execute(2, 10ms);
+    EXPECT_EQ(f.d_strategy.limit(), 10u);
+}
+
+TEST(AdaptiveConcurrencyStrategy, When_UsingAimdAndExecutionsAreSlow_Then_TheLimitDecreases)
+{
+    AdaptiveConcurrencyStrategy_F<AimdLimit> f{AimdLimit(100ms, 0.5), 10};
+    f.execute(1, 200ms);
+    EXPECT_EQ(f.d_strategy.limit(), 5u);
+}
+
+TEST(AdaptiveConcurrencyStrategy, When_UsingVegasAndTheLatencyIsStable_Then_TheLimitGrows)
+{
+    AdaptiveConcurrencyStrategy_F<VegasLimit> f{VegasLimit(), 10};
+    f.execute(10, 10ms);
+    EXPECT_GT(f.d_strategy.limit(), 10u);
+}
+
+TEST(AdaptiveConcurrencyStrategy, When_UsingVegasAndTheLatencyIncreases_Then_TheLimitDecreases)
+{
+    AdaptiveConcurrencyStrategy_F<VegasLimit> f{VegasLimit(), 20};
+    f.execute(1, 10ms);
+    // Half of the executions are queued
+    f.execute(1, 20ms);
+    EXPECT_EQ(f.d_strategy.limit(), 19u);
+}
+
+TEST(AdaptiveConcurrencyStrategy, When_UsingGradientAndTheLatencyIsStable_Then_TheLimitGrows)
+{
+    AdaptiveConcurrencyStrategy_F<GradientLimit> f{GradientLimit(), 10};
+    f.execute(10, 10ms);
+    EXPECT_GT(f.d_strategy.limit(), 10u);
+}
+
+TEST(AdaptiveConcurrencyStrategy, When_UsingGradientAndTheLatencyIncreases_Then_TheLimitDecreases)
+{
+    AdaptiveConcurrencyStrategy_F<GradientLimit> f{GradientLimit(), 50};
+    for (int i = 0; i < 10; i++) {
+        f.execute(50, 10ms);
+    }
+    const unsigned long before = f.d_strategy.limit();
+    for (int i = 0; i < 5; i++) {
+        f.execute(f.d_strategy.limit(), 40ms);
+    }
+    EXPECT_LT(f.d_strategy.limit(), before);
+}
+
+TEST(AdaptiveConcurrencyStrategy, When_UsedByARatelimiter_Then_ExecutionsAreLimited)
+{
+    using Strategy = AdaptiveConcurrencyStrategy<AimdLimit>;
+    Ratelimiter<Strategy> ratelimiter{
+        std::unique_ptr<Strategy>(new Strategy(AimdLimit(1s), 1, 1, 1))};
+
+    auto result = ratelimiter.execute([&ratelimiter]() {
+        // The limit is reached while the outer execution runs
+        auto inner = ratelimiter.execute([]() { return Failable<int, std::string>(1); });
+        EXPECT_TRUE(holds_failure(inner));
+        return Failable<int, std::string>(2);
+    });
+    EXPECT_TRUE(holds_value(result));
+}
@@ -4,6 +4,9 @@
 #include <resilient/policy/ratelimiterstrategy/blockingfixedconcurrentexecutionsstrategy.hpp>
 
 #include <chrono>
+#include <mutex>
+#include <thread>
+#include <vector>
 
 using namespace resilient;
 using namespace std::chrono_literals;
@@ -41,4 +44,62 @@ TEST(BlockingFixedConcurrentExecutionsStrategy,
     auto expected_success = bmces.acquire();
     EXPECT_TRUE(holds_alternative<MaxConcurrentPermit>(expected_success));
     bmces.release(std::move(get<MaxConcurrentPermit>(expected_success)));
-}
\ No newline at end of file
+}
+TEST(BlockingFixedConcurrentExecutionsStrategy,
+     When_WaitingInFifoOrderAndATimedOutRequestReturns_Then_ThePermitIsAvailable)
+{
+    BlockingFixedConcurrentExecutionsStrategy bmces{1, 1ms, WaitOrder::Fifo};
+    auto permit = bmces.acquire();
+    EXPECT_TRUE(holds_alternative<PermitAcquireTimeout>(bmces.acquire()));
+    EXPECT_TRUE(holds_alternative<PermitAcquireTimeout>(bmces.acquire()));
+    bmces.release(std::move(get<MaxConcurrentPermit>(permit)));
+
+    auto expected_success = bmces.acquire();
+    EXPECT_TRUE(holds_alternative<MaxConcurrentPermit>(expected_success));
+    bmces.release(std::move(get<MaxConcurrentPermit>(expected_success)));
+}
+
+TEST(BlockingFixedConcurrentExecutionsStrategy,
+     When_WaitingInFifoOrder_Then_PermitsAreHandedToTheOldestWaiterFirst)
+{
+    BlockingFixedConcurrentExecutionsStrategy bmces{1, 10s, WaitOrder::Fifo};
+    auto permit = bmces.acquire();
+
+    std::mutex mutex;
+    std::vector<int> order;
+    std::vector<std::thread> waiters;
+    for (int i = 0; i < 4; i++) {
+        waiters.emplace_back([&bmces, &mutex, &order, i]() {
+            auto waiterPermit = bmces.acquire();
+            ASSERT_TRUE(holds_alternative<MaxConcurrentPermit>(waiterPermit));
+            {
+                std::lock_guard<std::mutex> guard{mutex};
+                order.push_back(i);
+            }
+            bmces.release(std::move(get<MaxConcurrentPermit>(waiterPermit)));
+        });
+        // Give the thread the time to start waiting
+        std::this_thread::sleep_for(20ms);
+    }
+
+    bmces.release(std::move(get<MaxConcurrentPermit>(permit)));
+    for (std::thread& waiter : waiters) {
+        waiter.join();
+    }
+    EXPECT_EQ(order, (std::vector<int>{0, 1, 2, 3}));
+}
+
+TEST(BlockingFixedConcurrentExecutionsStrategy,
+     When_TryingToAcquireAndNoPermitIsAvailable_Then_ErrorIsReturnedWithoutWaiting)
+{
+    BlockingFixedConcurrentExecutionsStrategy bmces{1, 10s};
+    auto permit = bmces.tryAcquire();
+    EXPECT_TRUE(holds_alternative<MaxConcurrentPermit>(permit));
+
+    auto before = std::chrono::steady_clock::now();
+    EXPECT_TRUE(holds_alternative<PermitAcquireTimeout>(bmces.tryAcquire()));
+    EXPECT_LT(std::chrono::steady_clock::now() - before, 1s);
+
+    bmces.release(std::move(get<MaxConcurrentPermit>(permit)));
+    EXPECT_TRUE(holds_alternative<MaxConcurrentPermit>(bmces.tryAcquire()));
+}
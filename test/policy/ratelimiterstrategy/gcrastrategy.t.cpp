@@ -0,0 +1,136 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <resilient/policy/ratelimiterstrategy/gcrastrategy.hpp>
+#include <test/common/clockmock.t.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace resilient;
+using namespace std::chrono_literals;
+
+using resilient::test::ClockMock;
+using resilient::test::StrictClockMockState;
+
+namespace {
+
+struct GcraStrategy_F : ::testing::Test
+{
+    GcraStrategy_F() : d_clockState(), d_currentTime(0), d_strategy(10, 1s, 5, &d_clockState)
+    {
+        EXPECT_CALL(d_clockState, now())
+            .WillRepeatedly(::testing::Invoke(this, &GcraStrategy_F::testTime));
+    }
+
+    ClockMock::time_point testTime() { return ClockMock::time_point(d_currentTime); }
+
+    bool acquire() { return holds_alternative<GcraPermit>(d_strategy.acquire()); }
+
+    StrictClockMockState d_clockState;
+    std::chrono::milliseconds d_currentTime;
+    GcraStrategy<ClockMock> d_strategy;
+};
+
+} // namespace
+
+TEST_F(GcraStrategy_F, When_Constructed_Then_ABurstIsAllowed)
+{
+    for (int i = 0; i < 5; i++) {
+        EXPECT_TRUE(acquire());
+    }
+    EXPECT_FALSE(acquire());
+}
+
+TEST_F(GcraStrategy_F, When_TheLimitIsExceeded_Then_TheErrorTellsHowLongToWait)
+{
+    for (int i = 0; i < 5; i++) {
+        acquire();
+    }
+    d_currentTime += 30ms;
+    auto result = d_strategy.acquire();
+    ASSERT_TRUE(holds_alternative<RateLimitExceeded>(result));
+    EXPECT_EQ(get<RateLimitExceeded>(result).retryAfter, 70ms);
+
+    d_currentTime += 69ms;
+    EXPECT_FALSE(acquire());
+    d_currentTime += 1ms;
+    EXPECT_TRUE(acquire());
+}
+
+TEST_F(GcraStrategy_F, When_ExecutionsArriveAtTheRate_Then_TheyAreAllowed)
+{
+    for (int i = 0; i < 100; i++) {
+        EXPECT_TRUE(acquire());
+        d_currentTime += 100ms;
+    }
+}
+
+TEST_F(GcraStrategy_F, When_TheStrategyIsIdle_Then_AtMostABurstIsAllowed)
+{
+    d_currentTime += 10s;
+    for (int i = 0; i < 5; i++) {
+        EXPECT_TRUE(acquire());
+    }
+    EXPECT_FALSE(acquire());
+}
+
+TEST_F(GcraStrategy_F, When_AnExecutionHasAWeight_Then_ItUsesAsMuchOfTheBurst)
+{
+    EXPECT_TRUE(holds_alternative<GcraPermit>(d_strategy.acquire(3)));
+    EXPECT_TRUE(holds_alternative<GcraPermit>(d_strategy.acquire(2)));
+    EXPECT_FALSE(acquire());
+
+    d_currentTime += 200ms;
+    EXPECT_FALSE(holds_alternative<GcraPermit>(d_strategy.acquire(3)));
+    EXPECT_TRUE(holds_alternative<GcraPermit>(d_strategy.acquire(2)));
+}
+
+TEST_F(GcraStrategy_F, When_AnExecutionWeighsMoreThanTheBurst_Then_ItIsNotAllowed)
+{
+    EXPECT_FALSE(holds_alternative<GcraPermit>(d_strategy.acquire(6)));
+    EXPECT_TRUE(holds_alternative<GcraPermit>(d_strategy.acquire(5)));
+}
+
+TEST(GcraStrategy, When_ManyThreadsAcquire_Then_OnlyTheBurstIsAllowed)
+{
+    GcraStrategy<> strategy(1, 1000s, 100);
+    std::atomic<int> allowed{0};
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; t++) {
+        threads.emplace_back([&strategy, &allowed]() {
+            for (int i = 0; i < 100; i++) {
+                if (holds_alternative<GcraPermit>(strategy.acquire())) {
+                    allowed++;
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    EXPECT_EQ(allowed.load(), 100);
+}
+
+TEST(GcraStrategy, When_UsedByARatelimiter_Then_TheWaitIsReturned)
+{
+    Ratelimiter<GcraStrategy<>> ratelimiter{
+        std::unique_ptr<GcraStrategy<>>(new GcraStrategy<>(1, 1000s, 1))};
+    auto task = []() { return Failable<int, std::string>(1); };
+
+    EXPECT_TRUE(holds_value(ratelimiter.execute(task)));
+    auto result = ratelimiter.execute(task);
+    ASSERT_TRUE(holds_failure(result));
+    ASSERT_TRUE(holds_alternative<RateLimitExceeded>(get_failure(result)));
+    EXPECT_GT(get<RateLimitExceeded>(get_failure(result)).retryAfter, 900s);
+}
+
+TEST(GcraStrategy, When_NoExecutionIsAllowed_Then_TheConstructorThrows)
+{
+    EXPECT_THROW(GcraStrategy<>(0, 1s, 1), std::invalid_argument);
+}
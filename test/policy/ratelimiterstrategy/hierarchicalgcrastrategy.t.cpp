@@ -0,0 +1,111 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <resilient/policy/ratelimiterstrategy/hierarchicalgcrastrategy.hpp>
+#include <test/common/clockmock.t.hpp>
+
+#include <chrono>
+#include <string>
+
+using namespace resilient;
+using namespace std::chrono_literals;
+
+using resilient::test::ClockMock;
+using resilient::test::StrictClockMockState;
+
+namespace {
+
+struct HierarchicalGcraStrategy_F : ::testing::Test
+{
+    HierarchicalGcraStrategy_F()
+    : d_clockState()
+    , d_currentTime(0)
+    // 10 executions per second globally, 2 per second for each key
+    , d_strategy(GcraRate{10, 1s, 4}, GcraRate{2, 1s, 2}, 2, 10s, 1, &d_clockState)
+    {
+        EXPECT_CALL(d_clockState, now())
+            .WillRepeatedly(::testing::Invoke(this, &HierarchicalGcraStrategy_F::testTime));
+    }
+
+    ClockMock::time_point testTime() { return ClockMock::time_point(d_currentTime); }
+
+    bool acquire(const std::string& key)
+    {
+        return holds_alternative<GcraPermit>(d_strategy.acquire(key));
+    }
+
+    StrictClockMockState d_clockState;
+    std::chrono::milliseconds d_currentTime;
+    HierarchicalGcraStrategy<std::string, ClockMock> d_strategy;
+};
+
+} // namespace
+
+TEST_F(HierarchicalGcraStrategy_F, When_AKeyExceedsItsRate_Then_OtherKeysAreAllowed)
+{
+    EXPECT_TRUE(acquire("a"));
+    EXPECT_TRUE(acquire("a"));
+    EXPECT_FALSE(acquire("a"));
+    EXPECT_TRUE(acquire("b"));
+}
+
+TEST_F(HierarchicalGcraStrategy_F, When_TheGlobalRateIsExceeded_Then_AllKeysAreRejected)
+{
+    EXPECT_TRUE(acquire("a"));
+    EXPECT_TRUE(acquire("a"));
+    EXPECT_TRUE(acquire("b"));
+    EXPECT_TRUE(acquire("b"));
+    auto result = d_strategy.acquire("c");
+    ASSERT_TRUE(holds_alternative<RateLimitExceeded>(result));
+    EXPECT_EQ(get<RateLimitExceeded>(result).retryAfter, 100ms);
+}
+
+TEST_F(HierarchicalGcraStrategy_F, When_TheGlobalRateRejects_Then_TheKeyRateIsNotUsed)
+{
+    for (const char* key : {"a", "a", "b", "b"}) {
+        acquire(key);
+    }
+    for (int i = 0; i < 10; i++) {
+        EXPECT_FALSE(acquire("c"));
+    }
+    // The global rate allows one more execution: "c" still has its whole burst
+    d_currentTime += 100ms;
+    EXPECT_TRUE(acquire("c"));
+    d_currentTime += 100ms;
+    EXPECT_TRUE(acquire("c"));
+}
+
+TEST_F(HierarchicalGcraStrategy_F, When_AKeyRejects_Then_TheGlobalRateIsNotUsed)
+{
+    acquire("a");
+    acquire("a");
+    for (int i = 0; i < 10; i++) {
+        EXPECT_FALSE(acquire("a"));
+    }
+    EXPECT_TRUE(acquire("b"));
+    EXPECT_TRUE(acquire("b"));
+}
+
+TEST_F(HierarchicalGcraStrategy_F, When_TooManyKeysAreUsed_Then_TheIdleOnesAreForgotten)
+{
+    acquire("a");
+    acquire("b");
+    d_currentTime += 11s;
+    acquire("c");
+    EXPECT_EQ(d_strategy.size(), 1u);
+    d_currentTime += 11s;
+    EXPECT_EQ(d_strategy.evictIdle(), 1u);
+}
+
+TEST_F(HierarchicalGcraStrategy_F, When_UsedByARatelimiter_Then_TheKeyIsLimited)
+{
+    Ratelimiter<KeyedGcraStrategy<std::string, ClockMock>> ratelimiter{d_strategy.forKey("a")};
+    auto task = []() { return Failable<int, std::string>(1); };
+
+    EXPECT_TRUE(holds_value(ratelimiter.execute(task)));
+    EXPECT_TRUE(holds_value(ratelimiter.tryExecute(task)));
+    auto result = ratelimiter.execute(task);
+    ASSERT_TRUE(holds_failure(result));
+    EXPECT_TRUE(holds_alternative<RateLimitExceeded>(get_failure(result)));
+    EXPECT_TRUE(acquire("b"));
+}
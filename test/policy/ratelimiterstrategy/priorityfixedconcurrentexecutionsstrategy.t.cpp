@@ -0,0 +1,169 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <resilient/policy/ratelimiterstrategy/priorityfixedconcurrentexecutionsstrategy.hpp>
+
+#include <chrono>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace resilient;
+using namespace std::chrono_literals;
+
+namespace {
+
+struct PriorityFixedConcurrentExecutionsStrategy_F : ::testing::Test
+{
+    using Strategy = PriorityFixedConcurrentExecutionsStrategy<>;
+
+    // Start a thread which waits for a permit of the class, records it got it and releases it.
+    void startWaiter(Strategy& strategy, std::size_t priority)
+    {
+        d_waiters.emplace_back([this, &strategy, priority]() {
+            auto permit = strategy.acquire(priority);
+            ASSERT_TRUE(holds_alternative<PriorityPermit>(permit));
+            {
+                std::lock_guard<std::mutex> guard{d_mutex};
+                d_order.push_back(priority);
+            }
+            strategy.release(get<PriorityPermit>(permit));
+        });
+        // Give the thread the time to start waiting
+        std::this_thread::sleep_for(20ms);
+    }
+
+    void joinWaiters()
+    {
+        for (std::thread& waiter : d_waiters) {
+            waiter.join();
+        }
+    }
+
+    std::mutex d_mutex;
+    std::vector<std::size_t> d_order;
+    std::vector<std::thread> d_waiters;
+};
+
+} // namespace
+
+TEST_F(PriorityFixedConcurrentExecutionsStrategy_F,
+       When_ExecutionsOfManyClassesWait_Then_TheHighestPriorityRunsFirst)
+{
+    Strategy strategy{1, {PriorityClass{10s}, PriorityClass{10s}, PriorityClass{10s}}};
+    auto permit = strategy.acquire(0);
+
+    startWaiter(strategy, 2);
+    startWaiter(strategy, 1);
+    startWaiter(strategy, 0);
+    startWaiter(strategy, 2);
+    strategy.release(get<PriorityPermit>(permit));
+    joinWaiters();
+
+    EXPECT_EQ(d_order, (std::vector<std::size_t>{0, 1, 2, 2}));
+}
+
+TEST_F(PriorityFixedConcurrentExecutionsStrategy_F,
+       When_AClassHasReservedPermits_Then_ItIsServedBeforeHigherPriorities)
+{
+    PriorityClass low{10s};
+    low.reservedPermits = 1;
+    Strategy strategy{1, {PriorityClass{10s}, low}};
+    auto permit = strategy.acquire(0);
+
+    startWaiter(strategy, 0);
+    startWaiter(strategy, 1);
+    startWaiter(strategy, 0);
+    strategy.release(get<PriorityPermit>(permit));
+    joinWaiters();
+
+    EXPECT_EQ(d_order, (std::vector<std::size_t>{1, 0, 0}));
+}
+
+TEST(PriorityFixedConcurrentExecutionsStrategy,
+     When_AClassUsesItsMaxPermits_Then_TheOthersAreLeftToHigherPriorities)
+{
+    PriorityClass low{1ms};
+    low.maxPermits = 1;
+    PriorityFixedConcurrentExecutionsStrategy<> strategy{2, {PriorityClass{1ms}, low}};
+
+    auto lowPermit = strategy.tryAcquire(1);
+    EXPECT_TRUE(holds_alternative<PriorityPermit>(lowPermit));
+    EXPECT_TRUE(holds_alternative<PermitAcquireTimeout>(strategy.tryAcquire(1)));
+    EXPECT_TRUE(holds_alternative<PermitAcquireTimeout>(strategy.acquire(1)));
+
+    auto highPermit = strategy.acquire(0);
+    EXPECT_TRUE(holds_alternative<PriorityPermit>(highPermit));
+    strategy.release(get<PriorityPermit>(highPermit));
+    strategy.release(get<PriorityPermit>(lowPermit));
+}
+
+TEST(PriorityFixedConcurrentExecutionsStrategy,
+     When_ExecutionsRunOrTimeOut_Then_EachClassCountsThem)
+{
+    PriorityFixedConcurrentExecutionsStrategy<> strategy{
+        1, {PriorityClass{2ms}, PriorityClass{0ms}}};
+    auto permit = strategy.acquire(0);
+    EXPECT_TRUE(holds_alternative<PermitAcquireTimeout>(strategy.acquire(0)));
+    EXPECT_TRUE(holds_alternative<PermitAcquireTimeout>(strategy.acquire(1)));
+    EXPECT_TRUE(holds_alternative<PermitAcquireTimeout>(strategy.acquire(1)));
+    strategy.release(get<PriorityPermit>(permit));
+
+    const PriorityClassStatistics high = strategy.statistics(0);
+    EXPECT_EQ(high.acquired, 1u);
+    EXPECT_EQ(high.timedOut, 1u);
+    EXPECT_EQ(high.totalWaitTime, 0ns);
+    const PriorityClassStatistics low = strategy.statistics(1);
+    EXPECT_EQ(low.acquired, 0u);
+    EXPECT_EQ(low.timedOut, 2u);
+}
+
+TEST(PriorityFixedConcurrentExecutionsStrategy, When_AnExecutionWaits_Then_ItsWaitIsRecorded)
+{
+    PriorityFixedConcurrentExecutionsStrategy<> strategy{1, {PriorityClass{10s}}};
+    auto permit = strategy.acquire(0);
+    std::thread waiter([&strategy]() {
+        auto waiterPermit = strategy.acquire(0);
+        ASSERT_TRUE(holds_alternative<PriorityPermit>(waiterPermit));
+        strategy.release(get<PriorityPermit>(waiterPermit));
+    });
+    std::this_thread::sleep_for(20ms);
+    strategy.release(get<PriorityPermit>(permit));
+    waiter.join();
+
+    const PriorityClassStatistics statistics = strategy.statistics(0);
+    EXPECT_EQ(statistics.acquired, 2u);
+    EXPECT_GE(statistics.maxWaitTime, 15ms);
+    EXPECT_EQ(statistics.totalWaitTime, statistics.maxWaitTime);
+}
+
+TEST(PriorityFixedConcurrentExecutionsStrategy, When_UsedByARatelimiter_Then_ExecutionsAreLimited)
+{
+    PriorityFixedConcurrentExecutionsStrategy<> strategy{
+        1, {PriorityClass{1ms}, PriorityClass{1ms}}};
+    Ratelimiter<PriorityClassStrategy<>> high{strategy.forPriority(0)};
+    Ratelimiter<PriorityClassStrategy<>> low{strategy.forPriority(1)};
+
+    auto result = high.execute([&low]() {
+        auto inner = low.tryExecute([]() { return Failable<int, std::string>(1); });
+        EXPECT_TRUE(holds_failure(inner));
+        return Failable<int, std::string>(2);
+    });
+    EXPECT_TRUE(holds_value(result));
+    EXPECT_TRUE(holds_value(low.execute([]() { return Failable<int, std::string>(1); })));
+}
+
+TEST(PriorityFixedConcurrentExecutionsStrategy,
+     When_ThePriorityClassDoesNotExist_Then_ItIsRejected)
+{
+    PriorityFixedConcurrentExecutionsStrategy<> strategy{1, {PriorityClass{10s}}};
+
+    EXPECT_THROW(strategy.acquire(1), std::invalid_argument);
+    EXPECT_THROW(strategy.tryAcquire(1), std::invalid_argument);
+    EXPECT_THROW(strategy.statistics(1), std::invalid_argument);
+    EXPECT_THROW(strategy.forPriority(1), std::invalid_argument);
+    // The strategy is still usable
+    EXPECT_TRUE(holds_alternative<PriorityPermit>(strategy.tryAcquire(0)));
+}
@@ -0,0 +1,102 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <resilient/policy/ratelimiterstrategy/slidinglogstrategy.hpp>
+#include <test/common/clockmock.t.hpp>
+
+#include <chrono>
+
+using namespace resilient;
+using namespace std::chrono_literals;
+
+using resilient::test::ClockMock;
+using resilient::test::StrictClockMockState;
+
+namespace {
+
+struct SlidingLogStrategy_F : ::testing::Test
+{
+    SlidingLogStrategy_F() : d_clockState(), d_currentTime(0), d_strategy(3, 1s, &d_clockState)
+    {
+        EXPECT_CALL(d_clockState, now())
+            .WillRepeatedly(::testing::Invoke(this, &SlidingLogStrategy_F::testTime));
+    }
+
+    ClockMock::time_point testTime() { return ClockMock::time_point(d_currentTime); }
+
+    bool acquire() { return holds_alternative<SlidingLogPermit>(d_strategy.acquire()); }
+
+    StrictClockMockState d_clockState;
+    std::chrono::milliseconds d_currentTime;
+    SlidingLogStrategy<ClockMock> d_strategy;
+};
+
+} // namespace
+
+TEST_F(SlidingLogStrategy_F, When_TheLimitIsReached_Then_ExecutionsAreNotAllowed)
+{
+    for (int i = 0; i < 3; i++) {
+        EXPECT_TRUE(acquire());
+    }
+    EXPECT_FALSE(acquire());
+}
+
+TEST_F(SlidingLogStrategy_F, When_TheOldestExecutionLeavesTheWindow_Then_ANewOneIsAllowed)
+{
+    EXPECT_TRUE(acquire());
+    d_currentTime = 400ms;
+    EXPECT_TRUE(acquire());
+    EXPECT_TRUE(acquire());
+
+    d_currentTime = 999ms;
+    EXPECT_FALSE(acquire());
+    d_currentTime = 1000ms;
+    EXPECT_TRUE(acquire());
+    EXPECT_FALSE(acquire());
+    d_currentTime = 1400ms;
+    EXPECT_TRUE(acquire());
+    EXPECT_TRUE(acquire());
+    EXPECT_FALSE(acquire());
+}
+
+TEST_F(SlidingLogStrategy_F, When_TheLimitIsExceeded_Then_TheErrorTellsHowLongToWait)
+{
+    EXPECT_TRUE(acquire());
+    d_currentTime = 300ms;
+    EXPECT_TRUE(acquire());
+    EXPECT_TRUE(acquire());
+    d_currentTime = 600ms;
+    auto result = d_strategy.acquire();
+    ASSERT_TRUE(holds_alternative<RateLimitExceeded>(result));
+    EXPECT_EQ(get<RateLimitExceeded>(result).retryAfter, 400ms);
+}
+
+TEST_F(SlidingLogStrategy_F, When_ExecutionsAreAtTheBoundaryOfWindows_Then_NoWindowExceedsTheLimit)
+{
+    d_currentTime = 999ms;
+    for (int i = 0; i < 3; i++) {
+        EXPECT_TRUE(acquire());
+    }
+    d_currentTime = 1001ms;
+    EXPECT_FALSE(acquire());
+}
+
+TEST_F(SlidingLogStrategy_F, When_AnExecutionHasAWeight_Then_ItTakesAsManyEntries)
+{
+    EXPECT_TRUE(acquire());
+    d_currentTime = 500ms;
+    EXPECT_TRUE(acquire());
+    EXPECT_FALSE(holds_alternative<SlidingLogPermit>(d_strategy.acquire(2)));
+
+    d_currentTime = 1000ms;
+    // Only the first execution left the window
+    auto result = d_strategy.acquire(3);
+    ASSERT_TRUE(holds_alternative<RateLimitExceeded>(result));
+    EXPECT_EQ(get<RateLimitExceeded>(result).retryAfter, 500ms);
+    EXPECT_TRUE(holds_alternative<SlidingLogPermit>(d_strategy.acquire(2)));
+    EXPECT_FALSE(acquire());
+
+    d_currentTime = 2000ms;
+    EXPECT_TRUE(holds_alternative<SlidingLogPermit>(d_strategy.acquire(3)));
+    EXPECT_FALSE(holds_alternative<SlidingLogPermit>(d_strategy.acquire(4)));
+}
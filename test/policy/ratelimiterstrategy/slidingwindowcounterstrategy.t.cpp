@@ -0,0 +1,146 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <resilient/policy/ratelimiter.hpp>
+#include <resilient/policy/ratelimiterstrategy/slidingwindowcounterstrategy.hpp>
+#include <resilient/task/failable.hpp>
+#include <test/common/clockmock.t.hpp>
+
+#include <chrono>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace resilient;
+using namespace std::chrono_literals;
+
+using resilient::test::ClockMock;
+using resilient::test::StrictClockMockState;
+
+namespace {
+
+struct SlidingWindowCounterStrategy_F : ::testing::Test
+{
+    SlidingWindowCounterStrategy_F()
+    : d_clockState(), d_currentTime(0), d_strategy(10, 1s, ClockMock(useTestTime()))
+    {
+    }
+
+    // The strategy reads the clock in its constructor
+    StrictClockMockState* useTestTime()
+    {
+        EXPECT_CALL(d_clockState, now())
+            .WillRepeatedly(::testing::Invoke(this, &SlidingWindowCounterStrategy_F::testTime));
+        return &d_clockState;
+    }
+
+    ClockMock::time_point testTime() { return ClockMock::time_point(d_currentTime); }
+
+    bool acquire() { return holds_alternative<SlidingWindowCounterPermit>(d_strategy.acquire()); }
+
+    int acquireAll()
+    {
+        int allowed = 0;
+        while (acquire()) {
+            allowed++;
+        }
+        return allowed;
+    }
+
+    StrictClockMockState d_clockState;
+    std::chrono::milliseconds d_currentTime;
+    SlidingWindowCounterStrategy<ClockMock> d_strategy;
+};
+
+} // namespace
+
+TEST_F(SlidingWindowCounterStrategy_F, When_TheLimitIsReached_Then_ExecutionsAreNotAllowed)
+{
+    EXPECT_EQ(acquireAll(), 10);
+}
+
+TEST_F(SlidingWindowCounterStrategy_F, When_TheWindowChanges_Then_ThePreviousOneIsWeighted)
+{
+    acquireAll();
+    // Half of the previous window overlaps the sliding window
+    d_currentTime = 1500ms;
+    EXPECT_EQ(acquireAll(), 5);
+}
+
+TEST_F(SlidingWindowCounterStrategy_F,
+       When_ABurstIsAtTheEndOfAWindow_Then_TheNextIsNotAllowedABurst)
+{
+    d_currentTime = 999ms;
+    EXPECT_EQ(acquireAll(), 10);
+    d_currentTime = 1001ms;
+    EXPECT_EQ(acquireAll(), 0);
+}
+
+TEST_F(SlidingWindowCounterStrategy_F, When_MoreThanAWindowPassed_Then_ThePastIsForgotten)
+{
+    acquireAll();
+    d_currentTime = 2500ms;
+    EXPECT_EQ(acquireAll(), 10);
+}
+
+TEST_F(SlidingWindowCounterStrategy_F, When_TheLimitIsExceeded_Then_TheErrorTellsHowLongToWait)
+{
+    acquireAll();
+    d_currentTime = 1500ms;
+    acquireAll();
+    auto result = d_strategy.acquire();
+    ASSERT_TRUE(holds_alternative<RateLimitExceeded>(result));
+    auto wait = get<RateLimitExceeded>(result).retryAfter;
+    EXPECT_GT(wait, 0ms);
+
+    d_currentTime += std::chrono::duration_cast<std::chrono::milliseconds>(wait) + 1ms;
+    EXPECT_TRUE(acquire());
+}
+
+TEST_F(SlidingWindowCounterStrategy_F, When_AnExecutionHasAWeight_Then_ItCountsAsManyExecutions)
+{
+    EXPECT_TRUE(holds_alternative<SlidingWindowCounterPermit>(d_strategy.acquire(7)));
+    EXPECT_FALSE(holds_alternative<SlidingWindowCounterPermit>(d_strategy.acquire(4)));
+    EXPECT_EQ(acquireAll(), 3);
+}
+
+TEST_F(SlidingWindowCounterStrategy_F, When_AnExecutionWeighsMoreThanTheLimit_Then_ItIsNotAllowed)
+{
+    auto result = d_strategy.acquire(11);
+    ASSERT_TRUE(holds_alternative<RateLimitExceeded>(result));
+    EXPECT_EQ(get<RateLimitExceeded>(result).retryAfter, std::chrono::nanoseconds::max());
+}
+
+TEST(SlidingWindowCounterStrategy, When_TheLimitCantBeCounted_Then_TheConstructorThrows)
+{
+    const unsigned long maxLimit = (1ul << 20) - 1;
+    EXPECT_NO_THROW(SlidingWindowCounterStrategy<>(maxLimit, 1s));
+    EXPECT_THROW(SlidingWindowCounterStrategy<>(maxLimit + 1, 1s), std::invalid_argument);
+}
+
+TEST(SlidingWindowCounterStrategy, When_TheWindowIsEmpty_Then_TheConstructorThrows)
+{
+    EXPECT_THROW(SlidingWindowCounterStrategy<>(1, 0s), std::invalid_argument);
+}
+
+TEST(SlidingWindowCounterStrategy, When_ABatchIsLargerThanTheLimit_Then_ItIsAlwaysRejected)
+{
+    using Strategy = SlidingWindowCounterStrategy<>;
+    Ratelimiter<Strategy> ratelimiter{std::unique_ptr<Strategy>(new Strategy(2, 1000s))};
+    std::vector<int> values{1, 2, 3};
+    auto task = [](int value) { return Failable<int, std::string>(value); };
+
+    // Even if nothing ran in the window
+    for (auto& result : ratelimiter.executeBatch(values.begin(), values.end(), task)) {
+        ASSERT_TRUE(holds_failure(result));
+        EXPECT_TRUE(holds_alternative<RateLimitExceeded>(get_failure(result)));
+    }
+
+    // Split in chunks within the limit, the first one is allowed
+    auto results = ratelimiter.executeBatch(values.begin(), values.end(), 2, task);
+    ASSERT_EQ(results.size(), 3u);
+    EXPECT_TRUE(holds_value(results[0]));
+    EXPECT_TRUE(holds_value(results[1]));
+    EXPECT_TRUE(holds_failure(results[2]));
+}
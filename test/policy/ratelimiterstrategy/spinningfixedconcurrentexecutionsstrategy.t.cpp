@@ -0,0 +1,124 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <resilient/policy/ratelimiterstrategy/spinningfixedconcurrentexecutionsstrategy.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <limits>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+using namespace resilient;
+using namespace std::chrono_literals;
+
+TEST(SpinningFixedConcurrentExecutionsStrategy,
+     When_PermitsAreAvailableAndOneIsRequested_Then_APermitIsIssued)
+{
+    SpinningFixedConcurrentExecutionsStrategy strategy{1, 1ms};
+    auto permit = strategy.acquire();
+    EXPECT_TRUE(holds_alternative<MaxConcurrentPermit>(permit));
+    strategy.release(std::move(get<MaxConcurrentPermit>(permit)));
+}
+
+TEST(SpinningFixedConcurrentExecutionsStrategy,
+     When_PermitsAreNotAvailableAndOneIsRequested_Then_ErrorIsReturnedAfterTimeout)
+{
+    auto timeout = 2ms;
+    SpinningFixedConcurrentExecutionsStrategy strategy{0, timeout, 100us};
+    auto before = std::chrono::steady_clock::now();
+    auto permit = strategy.acquire();
+    auto after = std::chrono::steady_clock::now();
+    EXPECT_TRUE(holds_alternative<PermitAcquireTimeout>(permit));
+    EXPECT_GE(after - before, timeout);
+}
+
+TEST(SpinningFixedConcurrentExecutionsStrategy,
+     When_ReturningAPreviouslyIssuedPermit_Then_AnotherRequestCanGetIt)
+{
+    SpinningFixedConcurrentExecutionsStrategy strategy{1, 1ms};
+    auto permit = strategy.acquire();
+    auto expected_failure = strategy.acquire();
+    EXPECT_TRUE(holds_alternative<PermitAcquireTimeout>(expected_failure));
+    strategy.release(std::move(get<MaxConcurrentPermit>(permit)));
+
+    auto expected_success = strategy.acquire();
+    EXPECT_TRUE(holds_alternative<MaxConcurrentPermit>(expected_success));
+    strategy.release(std::move(get<MaxConcurrentPermit>(expected_success)));
+}
+
+TEST(SpinningFixedConcurrentExecutionsStrategy,
+     When_AnExecutionIsBlocked_Then_ItRunsWhenAPermitIsReleased)
+{
+    // No spinning: the waiter blocks on the futex
+    SpinningFixedConcurrentExecutionsStrategy strategy{1, 10s, 0us};
+    auto permit = strategy.acquire();
+
+    std::atomic<bool> acquired{false};
+    std::thread waiter([&strategy, &acquired]() {
+        auto waiterPermit = strategy.acquire();
+        acquired = holds_alternative<MaxConcurrentPermit>(waiterPermit);
+        if (acquired) {
+            strategy.release(std::move(get<MaxConcurrentPermit>(waiterPermit)));
+        }
+    });
+    std::this_thread::sleep_for(20ms);
+    EXPECT_FALSE(acquired);
+
+    strategy.release(std::move(get<MaxConcurrentPermit>(permit)));
+    waiter.join();
+    EXPECT_TRUE(acquired);
+}
+
+TEST(SpinningFixedConcurrentExecutionsStrategy,
+     When_ManyThreadsRunConcurrently_Then_TheLimitIsNeverExceeded)
+{
+    const int limit = 2;
+    SpinningFixedConcurrentExecutionsStrategy strategy{limit, 10s, 5us};
+    std::atomic<int> running{0};
+    std::atomic<int> maxRunning{0};
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 8; t++) {
+        threads.emplace_back([&]() {
+            for (int i = 0; i < 1000; i++) {
+                auto permit = strategy.acquire();
+                ASSERT_TRUE(holds_alternative<MaxConcurrentPermit>(permit));
+                int now = ++running;
+                int max = maxRunning.load();
+                while (now > max and not maxRunning.compare_exchange_weak(max, now)) {
+                }
+                --running;
+                strategy.release(std::move(get<MaxConcurrentPermit>(permit)));
+            }
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    EXPECT_LE(maxRunning.load(), limit);
+}
+
+TEST(SpinningFixedConcurrentExecutionsStrategy,
+     When_TryingToAcquireAndNoPermitIsAvailable_Then_ErrorIsReturnedWithoutWaiting)
+{
+    SpinningFixedConcurrentExecutionsStrategy strategy{1, 10s};
+    auto permit = strategy.tryAcquire();
+    EXPECT_TRUE(holds_alternative<MaxConcurrentPermit>(permit));
+
+    auto before = std::chrono::steady_clock::now();
+    EXPECT_TRUE(holds_alternative<PermitAcquireTimeout>(strategy.tryAcquire()));
+    EXPECT_LT(std::chrono::steady_clock::now() - before, 1s);
+
+    strategy.release(std::move(get<MaxConcurrentPermit>(permit)));
+    EXPECT_TRUE(holds_alternative<MaxConcurrentPermit>(strategy.tryAcquire()));
+}
+
+TEST(SpinningFixedConcurrentExecutionsStrategy,
+     When_MoreThanIntMaxExecutionsAreAllowed_Then_TheConstructorThrows)
+{
+    constexpr unsigned long intMax = std::numeric_limits<int>::max();
+    EXPECT_THROW(SpinningFixedConcurrentExecutionsStrategy(intMax + 1, 1ms), std::invalid_argument);
+    EXPECT_NO_THROW(SpinningFixedConcurrentExecutionsStrategy(intMax, 1ms));
+}
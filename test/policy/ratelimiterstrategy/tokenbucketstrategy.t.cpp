@@ -0,0 +1,211 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <resilient/policy/ratelimiterstrategy/tokenbucketstrategy.hpp>
+#include <test/common/clockmock.t.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace resilient;
+using namespace std::chrono_literals;
+
+using resilient::test::ClockMock;
+using resilient::test::StrictClockMockState;
+
+namespace {
+
+struct TokenBucketStrategy_F : ::testing::Test
+{
+    TokenBucketStrategy_F()
+    : d_clockState(), d_currentTime(0), d_strategy(10, 1s, 5, 0s, ClockMock(useTestTime()))
+    {
+    }
+
+    // The strategy reads the clock in its constructor
+    StrictClockMockState* useTestTime()
+    {
+        EXPECT_CALL(d_clockState, now())
+            .WillRepeatedly(::testing::Invoke(this, &TokenBucketStrategy_F::testTime));
+        return &d_clockState;
+    }
+
+    ClockMock::time_point testTime() { return ClockMock::time_point(d_currentTime); }
+
+    bool acquire()
+    {
+        auto permit = d_strategy.acquire();
+        if (holds_alternative<TokenBucketPermit>(permit)) {
+            d_strategy.release(get<TokenBucketPermit>(permit));
+            return true;
+        }
+        return false;
+    }
+
+    StrictClockMockState d_clockState;
+    std::chrono::milliseconds d_currentTime;
+    TokenBucketStrategy<ClockMock> d_strategy;
+};
+
+} // namespace
+
+TEST_F(TokenBucketStrategy_F, When_TheBucketIsFull_Then_ABurstIsAllowed)
+{
+    for (int i = 0; i < 5; i++) {
+        EXPECT_TRUE(acquire());
+    }
+    EXPECT_FALSE(acquire());
+}
+
+TEST_F(TokenBucketStrategy_F, When_TheBucketIsEmpty_Then_ItRefillsAtTheRate)
+{
+    for (int i = 0; i < 5; i++) {
+        acquire();
+    }
+    d_currentTime += 99ms;
+    EXPECT_FALSE(acquire());
+    d_currentTime += 1ms;
+    EXPECT_TRUE(acquire());
+    EXPECT_FALSE(acquire());
+}
+
+TEST_F(TokenBucketStrategy_F, When_TheStrategyIsIdle_Then_TheBucketHoldsAtMostTheBurst)
+{
+    d_currentTime += 10s;
+    for (int i = 0; i < 5; i++) {
+        EXPECT_TRUE(acquire());
+    }
+    EXPECT_FALSE(acquire());
+}
+
+TEST_F(TokenBucketStrategy_F, When_FailingToAcquire_Then_NoTokenIsTaken)
+{
+    for (int i = 0; i < 5; i++) {
+        acquire();
+    }
+    for (int i = 0; i < 10; i++) {
+        EXPECT_FALSE(acquire());
+    }
+    d_currentTime += 100ms;
+    EXPECT_TRUE(acquire());
+}
+
+TEST_F(TokenBucketStrategy_F, When_AnExecutionHasAWeight_Then_ItTakesAsManyTokens)
+{
+    EXPECT_TRUE(holds_alternative<TokenBucketPermit>(d_strategy.acquire(4)));
+    EXPECT_FALSE(holds_alternative<TokenBucketPermit>(d_strategy.acquire(2)));
+    EXPECT_TRUE(acquire());
+    EXPECT_FALSE(acquire());
+
+    d_currentTime += 200ms;
+    EXPECT_TRUE(holds_alternative<TokenBucketPermit>(d_strategy.acquire(2)));
+    EXPECT_FALSE(acquire());
+}
+
+TEST_F(TokenBucketStrategy_F, When_AnExecutionWeighsMoreThanTheBurst_Then_ItIsNotAllowed)
+{
+    EXPECT_FALSE(holds_alternative<TokenBucketPermit>(d_strategy.acquire(6)));
+    // No token was taken
+    EXPECT_TRUE(holds_alternative<TokenBucketPermit>(d_strategy.acquire(5)));
+}
+
+TEST(TokenBucketStrategy, When_ABatchIsLargerThanTheBurst_Then_ItIsRejectedWithoutWaiting)
+{
+    // The deficit could be waited for
+    Ratelimiter<TokenBucketStrategy<>> ratelimiter{
+        std::unique_ptr<TokenBucketStrategy<>>(new TokenBucketStrategy<>(1, 1s, 2, 1000s))};
+    std::vector<int> values{1, 2, 3};
+    auto task = [](int value) { return Failable<int, std::string>(value); };
+
+    const auto start = std::chrono::steady_clock::now();
+    for (auto& result : ratelimiter.executeBatch(values.begin(), values.end(), task)) {
+        ASSERT_TRUE(holds_failure(result));
+        EXPECT_TRUE(holds_alternative<PermitAcquireTimeout>(get_failure(result)));
+    }
+    EXPECT_LT(std::chrono::steady_clock::now() - start, 500ms);
+}
+
+TEST(TokenBucketStrategy, When_TheWaitIsShorterThanTheMaxWait_Then_ItWaitsForTheToken)
+{
+    TokenBucketStrategy<> strategy(1, 20ms, 1, 100ms);
+    EXPECT_TRUE(holds_alternative<TokenBucketPermit>(strategy.acquire()));
+
+    auto before = std::chrono::steady_clock::now();
+    EXPECT_TRUE(holds_alternative<TokenBucketPermit>(strategy.acquire()));
+    EXPECT_GE(std::chrono::steady_clock::now() - before, 15ms);
+}
+
+TEST(TokenBucketStrategy, When_TheWaitIsLongerThanTheMaxWait_Then_ItFailsImmediately)
+{
+    TokenBucketStrategy<> strategy(1, 1s, 1, 10ms);
+    EXPECT_TRUE(holds_alternative<TokenBucketPermit>(strategy.acquire()));
+
+    auto before = std::chrono::steady_clock::now();
+    EXPECT_TRUE(holds_alternative<PermitAcquireTimeout>(strategy.acquire()));
+    EXPECT_LT(std::chrono::steady_clock::now() - before, 500ms);
+}
+
+TEST(TokenBucketStrategy, When_TryingToAcquireAndTheBucketIsEmpty_Then_ItFailsWithoutWaiting)
+{
+    TokenBucketStrategy<> strategy(1, 20ms, 1, 10s);
+    EXPECT_TRUE(holds_alternative<TokenBucketPermit>(strategy.tryAcquire()));
+
+    auto before = std::chrono::steady_clock::now();
+    EXPECT_TRUE(holds_alternative<PermitAcquireTimeout>(strategy.tryAcquire()));
+    EXPECT_LT(std::chrono::steady_clock::now() - before, 10ms);
+}
+
+TEST(TokenBucketStrategy, When_ManyThreadsAcquire_Then_OnlyTheBurstIsAllowed)
+{
+    TokenBucketStrategy<> strategy(1, 1000s, 100, 0s);
+    std::atomic<int> allowed{0};
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; t++) {
+        threads.emplace_back([&strategy, &allowed]() {
+            for (int i = 0; i < 100; i++) {
+                if (holds_alternative<TokenBucketPermit>(strategy.acquire())) {
+                    allowed++;
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    EXPECT_EQ(allowed.load(), 100);
+}
+
+TEST(TokenBucketStrategy, When_UsedByARatelimiter_Then_ExecutionsAreLimited)
+{
+    Ratelimiter<TokenBucketStrategy<>> ratelimiter{
+        std::unique_ptr<TokenBucketStrategy<>>(new TokenBucketStrategy<>(1, 1000s, 1, 0s))};
+    auto task = []() { return Failable<int, std::string>(1); };
+
+    EXPECT_TRUE(holds_value(ratelimiter.execute(task)));
+    auto result = ratelimiter.execute(task);
+    ASSERT_TRUE(holds_failure(result));
+    EXPECT_TRUE(holds_alternative<PermitAcquireTimeout>(get_failure(result)));
+}
+
+TEST(TokenBucketStrategy, When_TryingToExecuteWithARatelimiter_Then_ItNeverWaits)
+{
+    Ratelimiter<TokenBucketStrategy<>> ratelimiter{
+        std::unique_ptr<TokenBucketStrategy<>>(new TokenBucketStrategy<>(1, 1000s, 1, 1000s))};
+    auto task = []() { return Failable<int, std::string>(1); };
+
+    EXPECT_TRUE(holds_value(ratelimiter.tryExecute(task)));
+    auto result = ratelimiter.tryExecute(task);
+    ASSERT_TRUE(holds_failure(result));
+    EXPECT_TRUE(holds_alternative<PermitAcquireTimeout>(get_failure(result)));
+}
+
+TEST(TokenBucketStrategy, When_NoTokenIsAddedOrHeld_Then_TheConstructorThrows)
+{
+    EXPECT_THROW(TokenBucketStrategy<>(0, 1s, 1, 0s), std::invalid_argument);
+    EXPECT_THROW(TokenBucketStrategy<>(1, 1s, 0, 0s), std::invalid_argument);
+}
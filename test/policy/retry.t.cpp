@@ -2,7 +2,12 @@
 #include <gtest/gtest.h>
 
 #include <chrono>
+#include <functional>
+#include <future>
+#include <stdexcept>
 #include <type_traits>
+#include <utility>
+#include <vector>
 
 #include <resilient/policy/retry/factory/referencestate.hpp>
 #include <resilient/policy/retry/retry.hpp>
@@ -26,6 +31,41 @@ struct RetryStateMock
 
 using RetryFactory = retry::ReferenceState<::testing::StrictMock<RetryStateMock>>;
 
+// Count how many times the state is returned to the factory.
+struct CountingRetryFactory : RetryFactory
+{
+    CountingRetryFactory(::testing::StrictMock<RetryStateMock>& state, int& returns)
+    : RetryFactory(state), d_returns(returns)
+    {
+    }
+
+    void returnRetryState(::testing::StrictMock<RetryStateMock>&) { d_returns++; }
+
+    int& d_returns;
+};
+
+// A scheduler which runs the scheduled functions only when the test asks.
+struct ManualScheduler
+{
+    void schedule(std::chrono::microseconds delay, std::function<void()> function)
+    {
+        d_delays.push_back(delay);
+        d_scheduled.push_back(std::move(function));
+    }
+
+    void runScheduled()
+    {
+        std::vector<std::function<void()>> scheduled;
+        scheduled.swap(d_scheduled);
+        for (auto& function : scheduled) {
+            function();
+        }
+    }
+
+    std::vector<std::chrono::microseconds> d_delays;
+    std::vector<std::function<void()>> d_scheduled;
+};
+
 // TODO test that the state is returned correctly to endExecution()
 
 TEST_F(SinglePolicies, When_CallFailsAndStrategyAllowsRetry_Then_CallIsMadeAgain)
@@ -59,4 +99,116 @@ TEST_F(SinglePolicies, When_StrategyDoesNotAllowRetry_Then_AnErrorIsReturned)
     EXPECT_TRUE(holds_failure(result));
     static_assert(std::is_same<NoMoreRetriesAvailable&, decltype(get_failure(result))>::value,
                   "Expected type");
-}
\ No newline at end of file
+}
+
+TEST_F(SinglePolicies, When_ExecutingAsyncAndTheCallFails_Then_TheRetryIsScheduled)
+{
+    EXPECT_CALL(d_callable, call())
+        .WillOnce(testing::Return(SingleFailureFailable{Failure()}))
+        .WillOnce(testing::Return(SingleFailureFailable(1)));
+
+    ::testing::StrictMock<RetryStateMock> stateMock;
+    EXPECT_CALL(stateMock, failedWith(testing::A<Failure>())).Times(1);
+    EXPECT_CALL(stateMock, shouldRetry()).WillOnce(testing::Return(retry::retry_after{5ms}));
+
+    retry::Retry<RetryFactory> retry{RetryFactory(stateMock)};
+    ManualScheduler scheduler;
+
+    auto future = retry.executeAsync(scheduler, std::ref(d_callable));
+    // Nobody waits: the retry is scheduled after the delay
+    ASSERT_EQ(scheduler.d_delays, (std::vector<std::chrono::microseconds>{5ms}));
+    EXPECT_EQ(future.wait_for(0s), std::future_status::timeout);
+
+    scheduler.runScheduled();
+    ASSERT_EQ(future.wait_for(0s), std::future_status::ready);
+    auto result = future.get();
+    EXPECT_TRUE(holds_value(result));
+    EXPECT_EQ(get_value(result), 1);
+}
+
+TEST_F(SinglePolicies, When_ExecutingAsyncAndTheStrategyDoesNotAllowRetry_Then_AnErrorIsReturned)
+{
+    EXPECT_CALL(d_callable, call()).WillOnce(testing::Return(SingleFailureFailable{Failure()}));
+
+    ::testing::StrictMock<RetryStateMock> stateMock;
+    EXPECT_CALL(stateMock, failedWith(testing::A<Failure>())).Times(1);
+    EXPECT_CALL(stateMock, shouldRetry()).WillOnce(testing::Return(NoMoreRetriesAvailable()));
+
+    retry::Retry<RetryFactory> retry{RetryFactory(stateMock)};
+    ManualScheduler scheduler;
+
+    auto future = retry.executeAsync(scheduler, std::ref(d_callable));
+    EXPECT_TRUE(scheduler.d_scheduled.empty());
+    ASSERT_EQ(future.wait_for(0s), std::future_status::ready);
+    EXPECT_TRUE(holds_failure(future.get()));
+}
+
+TEST(Retry, When_ExecutingAsyncAndTheTaskThrows_Then_TheFutureHoldsTheException)
+{
+    ::testing::StrictMock<RetryStateMock> stateMock;
+    EXPECT_CALL(stateMock, failedWith(testing::A<Failure>())).Times(1);
+    EXPECT_CALL(stateMock, shouldRetry()).WillOnce(testing::Return(retry::retry_after{0us}));
+
+    retry::Retry<RetryFactory> retry{RetryFactory(stateMock)};
+    ManualScheduler scheduler;
+
+    int calls = 0;
+    auto future = retry.executeAsync(
+        scheduler,
+        [&calls](int) {
+            if (calls++ > 0) {
+                throw std::runtime_error("error");
+            }
+            return SingleFailureFailable{Failure()};
+        },
+        1);
+    scheduler.runScheduled();
+    EXPECT_THROW(future.get(), std::runtime_error);
+    EXPECT_EQ(calls, 2);
+}
+
+TEST_F(SinglePolicies, When_ExecutingAsyncCompletes_Then_TheStateIsReturnedOnce)
+{
+    EXPECT_CALL(d_callable, call())
+        .WillOnce(testing::Return(SingleFailureFailable{Failure()}))
+        .WillOnce(testing::Return(SingleFailureFailable(1)));
+
+    ::testing::StrictMock<RetryStateMock> stateMock;
+    EXPECT_CALL(stateMock, failedWith(testing::A<Failure>())).Times(1);
+    EXPECT_CALL(stateMock, shouldRetry()).WillOnce(testing::Return(retry::retry_after{5ms}));
+
+    int returns = 0;
+    retry::Retry<CountingRetryFactory> retry{CountingRetryFactory(stateMock, returns)};
+    {
+        ManualScheduler scheduler;
+        auto future = retry.executeAsync(scheduler, std::ref(d_callable));
+        EXPECT_EQ(returns, 0);
+
+        scheduler.runScheduled();
+        ASSERT_EQ(future.wait_for(0s), std::future_status::ready);
+        EXPECT_EQ(returns, 1);
+    }
+    // Destroying the execution doesn't return it again
+    EXPECT_EQ(returns, 1);
+}
+
+TEST_F(SinglePolicies, When_TheSchedulerDropsTheRetry_Then_TheStateIsReturnedAndTheFutureFails)
+{
+    EXPECT_CALL(d_callable, call()).WillOnce(testing::Return(SingleFailureFailable{Failure()}));
+
+    ::testing::StrictMock<RetryStateMock> stateMock;
+    EXPECT_CALL(stateMock, failedWith(testing::A<Failure>())).Times(1);
+    EXPECT_CALL(stateMock, shouldRetry()).WillOnce(testing::Return(retry::retry_after{5ms}));
+
+    int returns = 0;
+    retry::Retry<CountingRetryFactory> retry{CountingRetryFactory(stateMock, returns)};
+    ManualScheduler scheduler;
+
+    auto future = retry.executeAsync(scheduler, std::ref(d_callable));
+    EXPECT_EQ(returns, 0);
+
+    scheduler.d_scheduled.clear();
+    EXPECT_EQ(returns, 1);
+    ASSERT_EQ(future.wait_for(0s), std::future_status::ready);
+    EXPECT_THROW(future.get(), std::runtime_error);
+}
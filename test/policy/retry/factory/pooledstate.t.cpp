@@ -0,0 +1,168 @@
+#include <gtest/gtest.h>
+
+#include <resilient/policy/retry/factory/pooledstate.hpp>
+#include <resilient/policy/retry/retry.hpp>
+#include <resilient/policy/retry/state/retries.hpp>
+#include <resilient/task/failable.hpp>
+
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace resilient;
+using namespace resilient::retry;
+
+namespace {
+
+int constructions = 0;
+int resets = 0;
+
+struct CountingState
+{
+    using stopretries_type = NoMoreRetriesLeft;
+
+    explicit CountingState(int id) : d_id(id), d_used(false) { constructions++; }
+
+    Variant<retry_after, stopretries_type> shouldRetry() { return NoMoreRetriesLeft(); }
+
+    template<typename T>
+    void failedWith(T)
+    {
+    }
+
+    int d_id;
+    bool d_used;
+};
+
+struct ResettableState : CountingState
+{
+    using CountingState::CountingState;
+
+    void reset()
+    {
+        resets++;
+        d_used = false;
+    }
+};
+
+template<typename State>
+struct PooledState_F : ::testing::Test
+{
+    PooledState_F()
+    {
+        constructions = 0;
+        resets = 0;
+    }
+
+    PooledState<State, int> d_factory{1};
+};
+
+using States = ::testing::Types<CountingState, ResettableState>;
+
+using Result = Failable<int, std::string>;
+
+} // namespace
+
+TYPED_TEST_CASE(PooledState_F, States);
+
+TYPED_TEST(PooledState_F, When_AStateIsReturned_Then_ItIsReusedOnTheSameThread)
+{
+    TypeParam& first = this->d_factory.getRetryState(retriedtask_failure<int>{});
+    first.d_used = true;
+    this->d_factory.returnRetryState(first);
+
+    TypeParam& second = this->d_factory.getRetryState(retriedtask_failure<int>{});
+    EXPECT_EQ(&first, &second);
+    EXPECT_FALSE(second.d_used);
+    EXPECT_EQ(second.d_id, 1);
+    this->d_factory.returnRetryState(second);
+}
+
+TYPED_TEST(PooledState_F, When_AllTheStatesAreInUse_Then_ANewOneIsConstructed)
+{
+    TypeParam& first = this->d_factory.getRetryState(retriedtask_failure<int>{});
+    TypeParam& second = this->d_factory.getRetryState(retriedtask_failure<int>{});
+    EXPECT_NE(&first, &second);
+    EXPECT_EQ(constructions, 2);
+    this->d_factory.returnRetryState(first);
+    this->d_factory.returnRetryState(second);
+}
+
+TYPED_TEST(PooledState_F, When_AnotherFactoryReturnedAState_Then_ItIsNotReused)
+{
+    PooledState<TypeParam, int> other{2};
+    TypeParam& otherState = other.getRetryState(retriedtask_failure<int>{});
+    other.returnRetryState(otherState);
+
+    TypeParam& state = this->d_factory.getRetryState(retriedtask_failure<int>{});
+    EXPECT_NE(&state, &otherState);
+    EXPECT_EQ(state.d_id, 1);
+    this->d_factory.returnRetryState(state);
+}
+
+TYPED_TEST(PooledState_F, When_AStateIsReturnedFromAnotherThread_Then_ItIsReused)
+{
+    TypeParam& first = this->d_factory.getRetryState(retriedtask_failure<int>{});
+    // As the scheduler of Retry::executeAsync() does
+    std::thread([this, &first]() { this->d_factory.returnRetryState(first); }).join();
+
+    TypeParam& second = this->d_factory.getRetryState(retriedtask_failure<int>{});
+    EXPECT_EQ(&first, &second);
+    this->d_factory.returnRetryState(second);
+}
+
+TYPED_TEST(PooledState_F, When_ACopyReturnsAState_Then_TheOriginalReusesIt)
+{
+    PooledState<TypeParam, int> copy = this->d_factory;
+    TypeParam& first = copy.getRetryState(retriedtask_failure<int>{});
+    copy.returnRetryState(first);
+
+    TypeParam& second = this->d_factory.getRetryState(retriedtask_failure<int>{});
+    EXPECT_EQ(&first, &second);
+    this->d_factory.returnRetryState(second);
+}
+
+TYPED_TEST(PooledState_F, When_AnotherFactoryFillsItsList_Then_TheStatesAreStillReused)
+{
+    TypeParam& first = this->d_factory.getRetryState(retriedtask_failure<int>{});
+    this->d_factory.returnRetryState(first);
+
+    PooledState<TypeParam, int> other{2};
+    std::vector<TypeParam*> otherStates;
+    for (std::size_t i = 0; i <= PooledState<TypeParam, int>::MaxFreeStates; i++) {
+        otherStates.push_back(&other.getRetryState(retriedtask_failure<int>{}));
+    }
+    for (TypeParam* state : otherStates) {
+        other.returnRetryState(*state);
+    }
+
+    TypeParam& second = this->d_factory.getRetryState(retriedtask_failure<int>{});
+    EXPECT_EQ(&first, &second);
+    this->d_factory.returnRetryState(second);
+}
+
+TEST(PooledState, When_TheStateCanBeReset_Then_ItIsNotConstructedAgain)
+{
+    constructions = 0;
+    resets = 0;
+    PooledState<ResettableState, int> factory{1};
+    for (int i = 0; i < 3; i++) {
+        factory.returnRetryState(factory.getRetryState(retriedtask_failure<int>{}));
+    }
+    EXPECT_EQ(constructions, 1);
+    EXPECT_EQ(resets, 2);
+}
+
+TEST(PooledState, When_UsedByRetry_Then_EachExecutionStartsFromAResetState)
+{
+    auto retry = retry::retry(pooledstate<Retries>(2u));
+    for (int execution = 0; execution < 3; execution++) {
+        int calls = 0;
+        auto result = retry.execute([&calls]() {
+            calls++;
+            return Result(std::string("failure"));
+        });
+        EXPECT_TRUE(holds_failure(result));
+        EXPECT_EQ(calls, 3);
+    }
+}
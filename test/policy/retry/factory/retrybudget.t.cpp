@@ -0,0 +1,146 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <resilient/policy/retry/factory/constructstate.hpp>
+#include <resilient/policy/retry/factory/retrybudget.hpp>
+#include <resilient/policy/retry/retry.hpp>
+#include <resilient/policy/retry/state/retries.hpp>
+#include <resilient/task/failable.hpp>
+
+#include <atomic>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace resilient;
+using namespace resilient::retry;
+
+namespace {
+
+using Result = Failable<int, std::string>;
+
+struct RetryBudget_F : ::testing::Test
+{
+    RetryBudget_F() : d_calls(0), d_retry(retrybudget(constructstate<Retries>(3u), 0.5, 2)) {}
+
+    Result fail()
+    {
+        d_calls++;
+        return Result(std::string("failure"));
+    }
+
+    Result succeed()
+    {
+        d_calls++;
+        return Result(1);
+    }
+
+    int d_calls;
+    Retry<RetryBudget<ConstructState<Retries, unsigned int>>> d_retry;
+};
+
+} // namespace
+
+TEST_F(RetryBudget_F, When_TheBudgetIsAvailable_Then_TheStateDecidesWhenToStop)
+{
+    auto result = d_retry.execute([this]() { return fail(); });
+    // The budget allows 2 of the 3 retries of the state
+    EXPECT_EQ(d_calls, 3);
+    ASSERT_TRUE(holds_failure(result));
+    EXPECT_TRUE(holds_alternative<RetryBudgetExhausted>(get_failure(result)));
+}
+
+TEST_F(RetryBudget_F, When_TheBudgetIsExhausted_Then_ExecutionsAreNotRetried)
+{
+    d_retry.execute([this]() { return fail(); });
+    d_calls = 0;
+    auto result = d_retry.execute([this]() { return fail(); });
+    EXPECT_EQ(d_calls, 1);
+    ASSERT_TRUE(holds_failure(result));
+    EXPECT_TRUE(holds_alternative<RetryBudgetExhausted>(get_failure(result)));
+}
+
+TEST_F(RetryBudget_F, When_ExecutionsSucceed_Then_TheyRefillTheBudget)
+{
+    d_retry.execute([this]() { return fail(); });
+    // Each success deposits half a token
+    d_retry.execute([this]() { return succeed(); });
+    d_retry.execute([this]() { return succeed(); });
+
+    d_calls = 0;
+    d_retry.execute([this]() { return fail(); });
+    EXPECT_EQ(d_calls, 2);
+}
+
+TEST_F(RetryBudget_F, When_ARetrySucceeds_Then_ItRefillsTheBudget)
+{
+    bool failed = false;
+    auto result = d_retry.execute([this, &failed]() {
+        if (failed) {
+            return succeed();
+        }
+        failed = true;
+        return fail();
+    });
+    EXPECT_TRUE(holds_value(result));
+
+    // One token was taken, half was given back
+    d_calls = 0;
+    d_retry.execute([this]() { return fail(); });
+    EXPECT_EQ(d_calls, 2);
+}
+
+TEST(RetryBudget, When_TheStateStops_Then_ItsFailureIsReturned)
+{
+    auto retry = retry::retry(retrybudget(constructstate<Retries>(1u), 0.1, 10));
+    auto result = retry.execute([]() { return Result(std::string("failure")); });
+    ASSERT_TRUE(holds_failure(result));
+    EXPECT_TRUE(holds_alternative<NoMoreRetriesLeft>(get_failure(result)));
+}
+
+TEST(RetryBudget, When_TheRatioIsBelowTheResolution_Then_TheConstructorThrows)
+{
+    EXPECT_THROW(retrybudget(constructstate<Retries>(1u), 0.0009, 10), std::invalid_argument);
+    EXPECT_THROW(retrybudget(constructstate<Retries>(1u), 0, 10), std::invalid_argument);
+    EXPECT_THROW(retrybudget(constructstate<Retries>(1u), -0.1, 10), std::invalid_argument);
+    EXPECT_THROW(retrybudget(
+                     constructstate<Retries>(1u), std::numeric_limits<double>::quiet_NaN(), 10),
+                 std::invalid_argument);
+}
+
+TEST(RetryBudget, When_TheRatioIsNotAWholeThousandth_Then_ItIsRounded)
+{
+    auto budget = retrybudget(constructstate<Retries>(1u), 0.0019999, 1);
+    // The copy of the factory shares the budget
+    auto retry = retry::retry(budget);
+    // Empty the budget, then refill it with one successful execution
+    retry.execute([]() { return Result(std::string("failure")); });
+    retry.execute([]() { return Result(1); });
+    EXPECT_DOUBLE_EQ(budget.tokens(), 0.002);
+}
+
+TEST(RetryBudget, When_ManyThreadsRetry_Then_TheBudgetIsNeverOverdrawn)
+{
+    auto budget = retrybudget(constructstate<Retries>(1000u), 0.1, 100);
+    std::atomic<int> calls{0};
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; t++) {
+        // The copies of the factory share the budget
+        threads.emplace_back([budget, &calls]() mutable {
+            auto retry = retry::retry(budget);
+            for (int i = 0; i < 10; i++) {
+                retry.execute([&calls]() {
+                    calls++;
+                    return Result(std::string("failure"));
+                });
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    EXPECT_EQ(calls.load(), 40 + 100);
+    EXPECT_EQ(budget.tokens(), 0);
+}
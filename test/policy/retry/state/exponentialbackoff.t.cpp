@@ -0,0 +1,110 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <resilient/policy/retry/factory/constructstate.hpp>
+#include <resilient/policy/retry/retry.hpp>
+#include <resilient/policy/retry/state/exponentialbackoff.hpp>
+#include <resilient/task/failable.hpp>
+
+#include <chrono>
+#include <set>
+#include <string>
+
+using namespace resilient;
+using namespace resilient::retry;
+using namespace std::chrono_literals;
+
+namespace {
+
+template<typename State>
+std::chrono::microseconds nextDelay(State& state)
+{
+    auto result = state.shouldRetry();
+    EXPECT_TRUE(holds_alternative<retry_after>(result));
+    return holds_alternative<retry_after>(result) ? get<retry_after>(result).value : 0us;
+}
+
+} // namespace
+
+TEST(ExponentialBackoff, When_UsingNoJitter_Then_TheDelayDoublesUpToTheMax)
+{
+    ExponentialBackoff<NoJitter> state{1ms, 10ms};
+    for (std::chrono::microseconds expected : {1ms, 2ms, 4ms, 8ms, 10ms, 10ms}) {
+        EXPECT_EQ(nextDelay(state), expected);
+    }
+}
+
+TEST(ExponentialBackoff, When_TheRetriesAreOver_Then_ItStopsRetrying)
+{
+    ExponentialBackoff<NoJitter> state{1ms, 10ms, 2};
+    nextDelay(state);
+    nextDelay(state);
+    EXPECT_TRUE(holds_alternative<NoMoreRetriesLeft>(state.shouldRetry()));
+}
+
+TEST(ExponentialBackoff, When_UsingFullJitter_Then_TheDelayIsUpToTheBackoff)
+{
+    std::set<long long> delays;
+    for (int i = 0; i < 100; i++) {
+        ExponentialBackoff<FullJitter> state{1ms, 10ms};
+        for (std::chrono::microseconds backoff : {1ms, 2ms, 4ms, 8ms, 10ms}) {
+            const std::chrono::microseconds delay = nextDelay(state);
+            EXPECT_GE(delay, 0us);
+            EXPECT_LE(delay, backoff);
+            delays.insert(delay.count());
+        }
+    }
+    // The delays are spread out
+    EXPECT_GT(delays.size(), 100u);
+}
+
+TEST(ExponentialBackoff, When_UsingEqualJitter_Then_TheDelayIsAtLeastHalfTheBackoff)
+{
+    for (int i = 0; i < 100; i++) {
+        ExponentialBackoff<EqualJitter> state{1ms, 10ms};
+        for (std::chrono::microseconds backoff : {1ms, 2ms, 4ms, 8ms, 10ms}) {
+            const std::chrono::microseconds delay = nextDelay(state);
+            EXPECT_GE(delay, backoff / 2);
+            EXPECT_LE(delay, backoff);
+        }
+    }
+}
+
+TEST(ExponentialBackoff, When_UsingDecorrelatedJitter_Then_TheDelayGrowsFromThePreviousOne)
+{
+    for (int i = 0; i < 100; i++) {
+        ExponentialBackoff<DecorrelatedJitter> state{1ms, 50ms};
+        std::chrono::microseconds previous = 1ms;
+        for (int retry = 0; retry < 10; retry++) {
+            const std::chrono::microseconds delay = nextDelay(state);
+            EXPECT_GE(delay, 1ms);
+            EXPECT_LE(delay, std::min<std::chrono::microseconds>(previous * 3, 50ms));
+            previous = delay;
+        }
+    }
+}
+
+TEST(ExponentialBackoff, When_Reset_Then_ItStartsFromTheInitialDelay)
+{
+    ExponentialBackoff<NoJitter> state(1ms, 100ms, 2u);
+    EXPECT_EQ(get<retry_after>(state.shouldRetry()).value, 1ms);
+    EXPECT_EQ(get<retry_after>(state.shouldRetry()).value, 2ms);
+    EXPECT_TRUE(holds_alternative<NoMoreRetriesLeft>(state.shouldRetry()));
+
+    state.reset();
+    EXPECT_EQ(get<retry_after>(state.shouldRetry()).value, 1ms);
+}
+
+TEST(ExponentialBackoff, When_UsedByARetry_Then_ItWaitsBetweenRetries)
+{
+    auto retry = retry::retry(constructstate<ExponentialBackoff<NoJitter>>(5ms, 5ms, 2u));
+    int calls = 0;
+    auto before = std::chrono::steady_clock::now();
+    auto result = retry.execute([&calls]() {
+        calls++;
+        return Failable<int, std::string>(std::string("failure"));
+    });
+    EXPECT_GE(std::chrono::steady_clock::now() - before, 10ms);
+    EXPECT_EQ(calls, 3);
+    EXPECT_TRUE(holds_failure(result));
+}